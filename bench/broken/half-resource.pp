@@ -0,0 +1,9 @@
+user { 'deploy':
+  ensure     => present,
+  managehome =>
+  shell      => '/bin/bash'
+  groups     => ['wheel', 'docker'
+
+file { ['/srv/app', '/srv/app/releases']:
+  ensure =>
+  owner  => 'deploy',
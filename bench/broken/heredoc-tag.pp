@@ -0,0 +1,5 @@
+$a = @(
+$b = @(END
+$c = @("END
+$d = @(END:json/z)
+notify { 'after heredoc tags': }
@@ -0,0 +1,8 @@
+$package = $facts['os']['family'] ? {
+  'RedHat' => 'httpd',
+  'Debian' =>
+  default  => 'apache2'
+
+$mode = $environment ? 
+$user = ? { default => 'root' }
+$group = $facts['kernel'] ? { 'Linux' => 'root', 'FreeBSD' => 'wheel',
@@ -0,0 +1,8 @@
+node 'web01.example.com' ) {
+  include role::web ? ;
+  => 'value'
+  Package <| title == 'nginx' |> -> ~> ->
+  $x = [1, 2, , 3]
+  $y = { 'a' => , 'b' => 2 }
+  @@ 
+}
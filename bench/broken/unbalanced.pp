@@ -0,0 +1,13 @@
+class profile::web (
+  Integer $port = 80,
+  String $docroot = '/var/www',
+{
+  if $port > 1024 {
+    notify { 'unprivileged port': }
+  }
+  }
+}
+]
+)
+class profile::db {
+  include mysql::server
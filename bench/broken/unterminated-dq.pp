@@ -0,0 +1,6 @@
+file { '/etc/motd':
+  ensure  => file,
+  content => "Welcome to ${facts['networking']['fqdn']}
+}
+
+notify { "unterminated ${message}:
@@ -0,0 +1,9 @@
+$banner = @("BANNER"/L)
+  This host is managed by Puppet.
+  Local changes to ${facts['networking']['hostname']} \
+  will be overwritten.
+  | BANNE
+
+file { '/etc/issue':
+  content => $banner,
+}
@@ -0,0 +1,6 @@
+$path = "/opt/${app_name/current"
+$url = "https://${host:${port}/${path"
+
+exec { "restart ${service":
+  command => "/bin/systemctl restart ${service}",
+}
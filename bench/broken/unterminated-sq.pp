@@ -0,0 +1,8 @@
+package { 'openssh-server':
+  ensure => 'installed,
+}
+
+service { 'sshd':
+  ensure => running,
+  enable => true,
+}
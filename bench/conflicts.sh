@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Compare the GLR forks and the parse time of two builds of the parser.
+#
+# Usage: bench/conflicts.sh before after
+#
+# Both directories must contain the puppet-gen, puppet-glr and puppet-bench
+# binaries, for example build-before/bench and build/bench of two
+# checkouts with regenerated parsers. The manifests are generated by the
+# puppet-gen of the first directory, so both builds parse the same input.
+# For every case the split count and the maximum number of stack versions
+# come from puppet-glr and the throughput and latency from puppet-bench.
+# The result is written as CSV to stdout. The environment variables SIZE,
+# SEED and ITERATIONS override the defaults.
+#
+# Cases:
+#   resource   manifests that only contain resource declarations
+#   mixed      the default mix of puppet-gen
+
+set -e
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 before after" >&2
+    exit 2
+fi
+
+SIZE=${SIZE:-4M}
+SEED=${SEED:-1}
+ITERATIONS=${ITERATIONS:-5}
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+field() {
+    sed -n "s/^  \"$2\": \([0-9.]*\),*$/\1/p" "$1"
+}
+
+"$1/puppet-gen" -s "$SEED" -b "$SIZE" -m resource=1,class=0,define=0,hash=0,array=0,selector=0,chain=0,string=0,heredoc=0,regex=0 -o "$TMP/resource.pp"
+"$1/puppet-gen" -s "$SEED" -b "$SIZE" -o "$TMP/mixed.pp"
+
+echo "build,case,bytes,splits,max_versions,mb_per_second,p50_us"
+
+for bin in "$1" "$2"; do
+    for case in resource mixed; do
+        "$bin/puppet-glr" -j "$TMP/glr.json" "$TMP/$case.pp" >/dev/null
+        "$bin/puppet-bench" -n "$ITERATIONS" -j "$TMP/bench.json" "$TMP/$case.pp" >/dev/null
+
+        p50=$(sed -n 's/^  "latency_us": {"p50": \([0-9.]*\),.*/\1/p' "$TMP/bench.json")
+
+        echo "$bin,$case,$(field "$TMP/bench.json" bytes),$(field "$TMP/glr.json" splits),$(field "$TMP/glr.json" max_versions),$(field "$TMP/bench.json" mb_per_second),$p50"
+    done
+done
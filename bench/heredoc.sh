@@ -0,0 +1,64 @@
+#!/bin/sh
+#
+# Regression benchmarks for the heredoc handling of the external scanner.
+#
+# Usage: bench/heredoc.sh [directory]
+#
+# The directory must contain the puppet-gen and puppet-bench binaries
+# (default: build/bench). Each case generates manifests that only contain
+# heredocs and varies one parameter. The scanner should show about the same
+# throughput for every value of the parameter; a throughput that drops
+# with the parameter points to super-linear behavior. The result is written
+# as CSV to stdout. The environment variables SIZE, SEED, LINE_LENGTHS,
+# BODY_LINES, UNTERMINATED_SIZES and ITERATIONS override the defaults.
+#
+# Cases:
+#   line-length   heredoc lines of the given length with periodic '\n'
+#                 escapes and '${}' interpolations
+#   body-lines    heredocs with the given number of 100 character lines
+#                 (10000 lines make a 1 MB heredoc)
+#   unterminated  manifests of the given size where every fifth statement
+#                 is a heredoc tag without an end tag
+
+set -e
+
+BIN=${1:-build/bench}
+SIZE=${SIZE:-4M}
+SEED=${SEED:-1}
+LINE_LENGTHS=${LINE_LENGTHS:-"100 1000 10000"}
+BODY_LINES=${BODY_LINES:-"100 1000 10000"}
+UNTERMINATED_SIZES=${UNTERMINATED_SIZES:-"64K 256K 1M"}
+ITERATIONS=${ITERATIONS:-3}
+MIX=heredoc=1,class=0,define=0,resource=0,hash=0,array=0,selector=0,chain=0,string=0,regex=0
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+field() {
+    sed -n "s/^  \"$1\": \([0-9.]*\),*$/\1/p" "$TMP/result.json"
+}
+
+run() {
+    "$BIN/puppet-bench" -n "$ITERATIONS" -j "$TMP/result.json" "$TMP/input.pp" >/dev/null
+
+    latency=$(sed -n 's/^  "latency_us": {"p50": \([0-9.]*\), "p99": \([0-9.]*\).*/\1,\2/p' "$TMP/result.json")
+
+    echo "$1,$2,$(field bytes),$(field mb_per_second),$latency"
+}
+
+echo "case,parameter,bytes,mb_per_second,p50_us,p99_us"
+
+for length in $LINE_LENGTHS; do
+    "$BIN/puppet-gen" -s "$SEED" -b "$SIZE" -m "$MIX" -l "$length" -o "$TMP/input.pp"
+    run line-length "$length"
+done
+
+for lines in $BODY_LINES; do
+    "$BIN/puppet-gen" -s "$SEED" -b "$SIZE" -m "$MIX" -l 100 -n "$lines" -o "$TMP/input.pp"
+    run body-lines "$lines"
+done
+
+for size in $UNTERMINATED_SIZES; do
+    "$BIN/puppet-gen" -s "$SEED" -b "$size" -m class=0,define=0,resource=4,hash=0,array=0,selector=0,chain=0,string=0,heredoc=0,regex=0,unterminated=1 -o "$TMP/input.pp"
+    run unterminated "$size"
+done
@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Build the library with profile-guided optimization and measure the gain.
+#
+# Usage: bench/pgo.sh [directory]
+#
+# Builds a plain release build in directory/base and a PGO build in
+# directory/pgo (default: build-pgo). The PGO build is instrumented,
+# trained with the pgo-train target and rebuilt with the profile. Both
+# builds then parse the test corpus and a generated manifest that differs
+# from the training manifest. The result is written as CSV to stdout and
+# the gain to stderr. CMAKE_ARGS adds options to both builds (for example
+# -DPUPPET_LTO=ON). The environment variables SIZE, SEED and ITERATIONS
+# override the defaults of the measured manifest.
+
+set -e
+
+DIR=${1:-build-pgo}
+SIZE=${SIZE:-10M}
+SEED=${SEED:-2}
+ITERATIONS=${ITERATIONS:-5}
+SOURCE=$(cd "$(dirname "$0")/.." && pwd)
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+field() {
+    sed -n "s/^  \"$1\": \([0-9.]*\),*$/\1/p" "$TMP/$2.json"
+}
+
+cmake -S "$SOURCE" -B "$DIR/base" -DCMAKE_BUILD_TYPE=Release -DPUPPET_BENCH=ON $CMAKE_ARGS >&2
+cmake --build "$DIR/base" >&2
+
+cmake -S "$SOURCE" -B "$DIR/pgo" -DCMAKE_BUILD_TYPE=Release -DPUPPET_BENCH=ON -DPUPPET_PGO=GENERATE $CMAKE_ARGS >&2
+cmake --build "$DIR/pgo" --target pgo-train >&2
+cmake -S "$SOURCE" -B "$DIR/pgo" -DPUPPET_PGO=USE >&2
+cmake --build "$DIR/pgo" >&2
+
+"$DIR/base/bench/puppet-gen" -s "$SEED" -b "$SIZE" -o "$TMP/input.pp"
+
+echo "build,bytes,mb_per_second,p50_us,p99_us"
+
+for build in base pgo; do
+    "$DIR/$build/bench/puppet-bench" -n "$ITERATIONS" -j "$TMP/$build.json" \
+        "$SOURCE/test/corpus" "$TMP/input.pp" >/dev/null
+
+    latency=$(sed -n 's/^  "latency_us": {"p50": \([0-9.]*\), "p99": \([0-9.]*\).*/\1,\2/p' "$TMP/$build.json")
+
+    echo "$build,$(field bytes "$build"),$(field mb_per_second "$build"),$latency"
+done
+
+awk "BEGIN { printf \"pgo gain: %.1f%%\\n\", ($(field mb_per_second pgo) / $(field mb_per_second base) - 1) * 100 }" >&2
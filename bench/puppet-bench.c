@@ -0,0 +1,271 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Parse throughput benchmark
+ *
+ * Usage: puppet-bench [-n iterations] [-j file] [path ...]
+ *
+ * Every path may be a Puppet manifest, a file in the tree-sitter corpus
+ * format or a directory that is searched for both. Without a path the test
+ * corpus of this repository is used. Each input is parsed once to warm up
+ * and count the nodes and then the given number of times for the timing.
+ * A summary is written to stdout and optionally as JSON to the given file
+ * ('-' is stdout). The allocations of the timed iterations are counted
+ * through the tree-sitter allocator; the external scanner only uses it if
+ * the library has been built with TREE_SITTER_REUSE_ALLOCATOR. If the
+ * library has been built with scanner statistics, the counters of the timed
+ * iterations are included.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+#include "util.h"
+
+#ifndef PUPPET_BENCH_CORPUS
+#define PUPPET_BENCH_CORPUS "test/corpus"
+#endif
+
+
+typedef struct {
+  uint64_t nodes;
+  bool     has_error;
+  double   *samples;              // parse time per iteration in µs
+} InputResult;
+
+static uint64_t allocation_count;
+
+
+/**
+ * Allocation functions for tree-sitter that count the allocations.
+ */
+
+static void *counting_malloc(size_t size) {
+  allocation_count++;
+  return malloc(size);
+}
+
+static void *counting_calloc(size_t count, size_t size) {
+  allocation_count++;
+  return calloc(count, size);
+}
+
+static void *counting_realloc(void *ptr, size_t size) {
+  allocation_count++;
+  return realloc(ptr, size);
+}
+
+/**
+ * Count all nodes of a tree, including anonymous nodes.
+ */
+
+static uint64_t count_nodes(TSTree *tree) {
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  uint64_t count = 1;
+
+  for (;;) {
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+      count++;
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return count;
+      }
+    }
+    count++;
+  }
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "Usage: %s [-n iterations] [-j file] [path ...]\n", program);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  BenchInputs inputs = {0};
+  const char *json_path = NULL;
+  int iterations = 10;
+  int option;
+
+  while ((option = getopt(argc, argv, "n:j:h")) != -1) {
+    switch (option) {
+    case 'n':
+      iterations = atoi(optarg);
+      if (iterations < 1) usage(argv[0]);
+      break;
+    case 'j':
+      json_path = optarg;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind == argc) {
+    if (!bench_inputs_add(&inputs, PUPPET_BENCH_CORPUS)) return 1;
+  }
+  for (int i = optind; i < argc; i++) {
+    if (!bench_inputs_add(&inputs, argv[i])) return 1;
+  }
+  if (inputs.size == 0) {
+    fprintf(stderr, "%s: no input files\n", argv[0]);
+    return 1;
+  }
+
+  ts_set_allocator(counting_malloc, counting_calloc, counting_realloc, free);
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_puppet());
+
+  InputResult *results = calloc(inputs.size, sizeof(InputResult));
+  double *latencies = malloc(inputs.size * iterations * sizeof(double));
+  uint64_t total_nodes = 0, total_ns = 0;
+  size_t error_count = 0;
+
+  // Warm-up round, also used to count the nodes
+  for (size_t i = 0; i < inputs.size; i++) {
+    BenchInput *input = &inputs.contents[i];
+    TSTree *tree = ts_parser_parse_string(parser, NULL, input->source, input->length);
+
+    results[i].nodes = count_nodes(tree);
+    results[i].has_error = ts_node_has_error(ts_tree_root_node(tree));
+    results[i].samples = malloc(iterations * sizeof(double));
+    total_nodes += results[i].nodes;
+    if (results[i].has_error) error_count++;
+    ts_tree_delete(tree);
+  }
+
+#ifdef TREE_SITTER_PUPPET_STATS
+  tree_sitter_puppet_scanner_stats_reset();
+#endif
+  allocation_count = 0;
+
+  for (int n = 0; n < iterations; n++) {
+    for (size_t i = 0; i < inputs.size; i++) {
+      BenchInput *input = &inputs.contents[i];
+      uint64_t start = bench_now_ns();
+      TSTree *tree = ts_parser_parse_string(parser, NULL, input->source, input->length);
+      uint64_t elapsed = bench_now_ns() - start;
+
+      ts_tree_delete(tree);
+      total_ns += elapsed;
+      results[i].samples[n] = (double)elapsed / 1e3;
+      latencies[n * inputs.size + i] = (double)elapsed / 1e3;
+    }
+  }
+
+  uint64_t bytes = bench_inputs_bytes(&inputs);
+  double seconds = (double)total_ns / 1e9;
+  double mb_per_second = (double)bytes * iterations / 1e6 / seconds;
+  double nodes_per_second = (double)total_nodes * iterations / seconds;
+  size_t sample_count = inputs.size * iterations;
+  double p50 = bench_percentile(latencies, sample_count, 50.0);
+  double p99 = bench_percentile(latencies, sample_count, 99.0);
+  double max = latencies[sample_count - 1];
+  double allocations_per_mb = (double)allocation_count / ((double)bytes * iterations / 1e6);
+  long peak_rss = bench_peak_rss_kb();
+
+  printf("inputs:      %zu (%llu bytes, %zu with errors)\n",
+         inputs.size, (unsigned long long)bytes, error_count);
+  printf("iterations:  %d\n", iterations);
+  printf("throughput:  %.2f MB/s\n", mb_per_second);
+  printf("nodes:       %llu (%.0f nodes/s)\n",
+         (unsigned long long)total_nodes, nodes_per_second);
+  printf("latency:     p50 %.1f us, p99 %.1f us, max %.1f us\n", p50, p99, max);
+  printf("allocations: %llu (%.0f per MB)\n",
+         (unsigned long long)allocation_count, allocations_per_mb);
+  printf("peak rss:    %ld KB\n", peak_rss);
+
+  char *scanner_stats = NULL;
+#ifdef TREE_SITTER_PUPPET_STATS
+  size_t stats_length = tree_sitter_puppet_scanner_stats_json(NULL, 0);
+  scanner_stats = malloc(stats_length + 1);
+  tree_sitter_puppet_scanner_stats_json(scanner_stats, stats_length + 1);
+  printf("scanner:     %s\n", scanner_stats);
+#endif
+
+  if (json_path) {
+    FILE *json = strcmp(json_path, "-") ? fopen(json_path, "w") : stdout;
+
+    if (!json) {
+      perror(json_path);
+      return 1;
+    }
+
+    fprintf(json, "{\n  \"iterations\": %d,\n", iterations);
+    fprintf(json, "  \"bytes\": %llu,\n", (unsigned long long)bytes);
+    fprintf(json, "  \"nodes\": %llu,\n", (unsigned long long)total_nodes);
+    fprintf(json, "  \"errors\": %zu,\n", error_count);
+    fprintf(json, "  \"seconds\": %.6f,\n", seconds);
+    fprintf(json, "  \"mb_per_second\": %.3f,\n", mb_per_second);
+    fprintf(json, "  \"nodes_per_second\": %.0f,\n", nodes_per_second);
+    fprintf(json, "  \"latency_us\": {\"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f},\n",
+            p50, p99, max);
+    fprintf(json, "  \"allocations\": %llu,\n", (unsigned long long)allocation_count);
+    fprintf(json, "  \"allocations_per_mb\": %.1f,\n", allocations_per_mb);
+    fprintf(json, "  \"peak_rss_kb\": %ld,\n", peak_rss);
+    if (scanner_stats) {
+      fprintf(json, "  \"scanner_stats\": %s,\n", scanner_stats);
+    }
+    fprintf(json, "  \"inputs\": [");
+    for (size_t i = 0; i < inputs.size; i++) {
+      fprintf(json, "%s\n    {\"name\": ", i ? "," : "");
+      bench_json_string(json, inputs.contents[i].name);
+      fprintf(json, ", \"bytes\": %u, \"nodes\": %llu, \"error\": %s, \"p50_us\": %.3f}",
+              inputs.contents[i].length,
+              (unsigned long long)results[i].nodes,
+              results[i].has_error ? "true" : "false",
+              bench_percentile(results[i].samples, iterations, 50.0));
+    }
+    fprintf(json, "\n  ]\n}\n");
+
+    if (json != stdout) fclose(json);
+  }
+
+  for (size_t i = 0; i < inputs.size; i++) {
+    free(results[i].samples);
+  }
+  free(scanner_stats);
+  free(results);
+  free(latencies);
+  ts_parser_delete(parser);
+  bench_inputs_delete(&inputs);
+
+  return 0;
+}
@@ -0,0 +1,268 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Chunked parse benchmark
+ *
+ * Usage: puppet-chunks [-t threads] [-s chunk_size] [-n iterations] path ...
+ *
+ * Splits every manifest into chunks of at least the given size (default
+ * 256K) with tree_sitter_puppet_chunks_find and parses the chunks on the
+ * given number of threads (default: the number of online processors). The
+ * time of the chunked parse, including the split, is compared with a
+ * single-threaded parse of the complete manifest.
+ *
+ * The top-level nodes of the chunk trees are compared with the top-level
+ * nodes of the single parse: every subtree must have the same symbols, byte
+ * offsets and children. The program fails if a tree differs, so it also
+ * checks the split points.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet-chunks.h>
+
+#include "util.h"
+
+
+/**
+ * Compare the subtrees of two nodes. Return false and print the position of
+ * the first difference if they are not the same.
+ */
+
+static bool compare_nodes(const char *name, TSNode expected, TSNode actual) {
+  TSTreeCursor expected_cursor = ts_tree_cursor_new(expected);
+  TSTreeCursor actual_cursor = ts_tree_cursor_new(actual);
+  bool same = true;
+
+  for (;;) {
+    TSNode a = ts_tree_cursor_current_node(&expected_cursor);
+    TSNode b = ts_tree_cursor_current_node(&actual_cursor);
+
+    if (ts_node_symbol(a) != ts_node_symbol(b) ||
+        ts_node_start_byte(a) != ts_node_start_byte(b) ||
+        ts_node_end_byte(a) != ts_node_end_byte(b) ||
+        ts_node_child_count(a) != ts_node_child_count(b)) {
+      TSPoint point = ts_node_start_point(a);
+
+      fprintf(stderr, "%s:%u:%u: %s differs from the chunked parse (%s)\n", name,
+              point.row + 1, point.column + 1, ts_node_type(a), ts_node_type(b));
+      same = false;
+      break;
+    }
+
+    // Both cursors have the same shape, so they move in lockstep
+    if (ts_tree_cursor_goto_first_child(&expected_cursor)) {
+      ts_tree_cursor_goto_first_child(&actual_cursor);
+      continue;
+    }
+
+    bool next = false;
+
+    while (!next) {
+      if (ts_tree_cursor_goto_next_sibling(&expected_cursor)) {
+        ts_tree_cursor_goto_next_sibling(&actual_cursor);
+        next = true;
+      } else if (ts_tree_cursor_goto_parent(&expected_cursor)) {
+        ts_tree_cursor_goto_parent(&actual_cursor);
+      } else {
+        break;
+      }
+    }
+    if (!next) break;
+  }
+
+  ts_tree_cursor_delete(&expected_cursor);
+  ts_tree_cursor_delete(&actual_cursor);
+  return same;
+}
+
+/**
+ * Compare the top-level nodes of the single tree with those of the chunk
+ * trees in order.
+ */
+
+static bool compare_trees(const char *name, TSTree *tree, TSTree **trees, size_t count) {
+  TSNode root = ts_tree_root_node(tree);
+  uint32_t child_count = ts_node_child_count(root), child = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    TSNode chunk = ts_tree_root_node(trees[i]);
+
+    for (uint32_t j = 0; j < ts_node_child_count(chunk); j++, child++) {
+      if (child == child_count) {
+        fprintf(stderr, "%s: the chunked parse has more top-level nodes\n", name);
+        return false;
+      }
+      if (!compare_nodes(name, ts_node_child(root, child), ts_node_child(chunk, j))) {
+        return false;
+      }
+    }
+  }
+
+  if (child < child_count) {
+    fprintf(stderr, "%s: the chunked parse has less top-level nodes\n", name);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Parse a size with an optional K or M suffix (powers of 1024).
+ */
+
+static bool parse_size(const char *text, uint64_t *size) {
+  char *end;
+  unsigned long long value = strtoull(text, &end, 10);
+
+  switch (*end) {
+  case 'k': case 'K': value <<= 10; end++; break;
+  case 'm': case 'M': value <<= 20; end++; break;
+  }
+
+  *size = value;
+  return (end != text) && (*end == '\0');
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "Usage: %s [-t threads] [-s chunk_size] [-n iterations] path ...\n",
+          program);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  BenchInputs inputs = {0};
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned threads = processors > 0 ? (unsigned)processors : 1;
+  uint64_t chunk_size = 256 * 1024;
+  int iterations = 5;
+  int option, failures = 0;
+
+  while ((option = getopt(argc, argv, "t:s:n:h")) != -1) {
+    switch (option) {
+    case 't':
+      if (atoi(optarg) < 1) usage(argv[0]);
+      threads = (unsigned)atoi(optarg);
+      break;
+    case 's':
+      if (!parse_size(optarg, &chunk_size) || chunk_size == 0 || chunk_size > UINT32_MAX) {
+        usage(argv[0]);
+      }
+      break;
+    case 'n':
+      iterations = atoi(optarg);
+      if (iterations < 1) usage(argv[0]);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind == argc) usage(argv[0]);
+  for (int i = optind; i < argc; i++) {
+    if (!bench_inputs_add(&inputs, argv[i])) return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+
+  ts_parser_set_language(parser, tree_sitter_puppet());
+
+  printf("%-40s %8s %12s %12s %10s\n", "input", "chunks", "single ms", "chunked ms", "speedup");
+
+  for (size_t i = 0; i < inputs.size; i++) {
+    const BenchInput *input = &inputs.contents[i];
+    uint64_t single = UINT64_MAX, chunked = UINT64_MAX;
+    TSTree *tree = NULL, **trees = NULL;
+    TSRange *ranges = NULL;
+    size_t count = 0;
+
+    for (int n = 0; n < iterations; n++) {
+      uint64_t start = bench_now_ns();
+
+      if (tree) ts_tree_delete(tree);
+      tree = ts_parser_parse_string(parser, NULL, input->source, input->length);
+
+      uint64_t middle = bench_now_ns();
+
+      if (trees) {
+        for (size_t j = 0; j < count; j++) {
+          ts_tree_delete(trees[j]);
+        }
+        free(trees);
+        free(ranges);
+        trees = NULL;
+      }
+      count = tree_sitter_puppet_chunks_find(input->source, input->length,
+                                             (uint32_t)chunk_size, &ranges);
+      if (count == 0) {
+        fprintf(stderr, "%s: out of memory\n", input->name);
+        break;
+      }
+      trees = malloc(count * sizeof(TSTree *));
+      if (!trees || !tree_sitter_puppet_chunks_parse(input->source, input->length, ranges, count,
+                                           threads, trees)) {
+        fprintf(stderr, "%s: chunked parse failed\n", input->name);
+        free(trees);
+        trees = NULL;
+        break;
+      }
+
+      uint64_t end = bench_now_ns();
+
+      if (middle - start < single) single = middle - start;
+      if (end - middle < chunked) chunked = end - middle;
+    }
+
+    if (!trees || !compare_trees(input->name, tree, trees, count)) {
+      failures++;
+    } else {
+      printf("%-40s %8zu %12.2f %12.2f %10.2f\n", input->name, count, (double)single / 1e6,
+             (double)chunked / 1e6, (double)single / (double)chunked);
+    }
+
+    if (trees) {
+      for (size_t j = 0; j < count; j++) {
+        ts_tree_delete(trees[j]);
+      }
+    }
+    free(trees);
+    free(ranges);
+    ts_tree_delete(tree);
+  }
+
+  ts_parser_delete(parser);
+  bench_inputs_delete(&inputs);
+  return failures ? 1 : 0;
+}
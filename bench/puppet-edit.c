@@ -0,0 +1,351 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Incremental reparse benchmark
+ *
+ * Usage: puppet-edit [-e edits] [-s seed] [path ...]
+ *
+ * Replays edits of the inputs (default: the test corpus) through
+ * ts_tree_edit and an incremental ts_parser_parse and measures the latency
+ * of every reparse. Two kinds of edits are replayed:
+ *
+ *   typing  the input is typed character by character from the start
+ *   random  a random character is deleted and inserted again
+ *
+ * At most the given number of edits (default 1000) of each kind are made
+ * per input. The edits are classified by the node of the complete input at
+ * the edit position: inside a heredoc, inside a double quoted string or
+ * anywhere else. This separates the edits where the serialized state of
+ * the external scanner decides how much of the old tree can be reused.
+ *
+ * The program is built twice from this file. puppet-edit uses the library
+ * as it is configured and reports the latencies. puppet-edit-stats is
+ * built with PUPPET_EDIT_STATS and compiles the parser and the scanner with
+ * the statistics, so it reports the characters the scanner advanced over
+ * per edit instead. Both replay the same edits for the same seed.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+#include "util.h"
+
+#ifndef PUPPET_BENCH_CORPUS
+#define PUPPET_BENCH_CORPUS "test/corpus"
+#endif
+
+enum { EDIT_TYPING, EDIT_RANDOM, EDIT_KIND_COUNT };
+enum { CONTEXT_CODE, CONTEXT_STRING, CONTEXT_HEREDOC, CONTEXT_COUNT };
+
+static const char *EDIT_KIND_NAMES[EDIT_KIND_COUNT] = { "typing", "random" };
+static const char *CONTEXT_NAMES[CONTEXT_COUNT] = { "code", "string", "heredoc" };
+
+
+typedef struct {
+  double   *latencies;            // nanoseconds per reparse
+  size_t   count;
+  size_t   capacity;
+  uint64_t chars;                 // characters read by the scanner
+  uint64_t max_chars;
+} EditStats;
+
+typedef struct {
+  const BenchInput *input;
+  uint32_t *lines;                // byte offset of every line of the input
+  uint32_t line_count;
+  TSTree   *reference;            // tree of the complete input
+} Document;
+
+
+/**
+ * Return the point of a byte offset in the input.
+ */
+
+static TSPoint document_point(const Document *document, uint32_t offset) {
+  uint32_t low = 0, high = document->line_count;
+
+  // The last line that starts at or before the offset
+  while (high - low > 1) {
+    uint32_t middle = low + (high - low) / 2;
+
+    if (document->lines[middle] <= offset) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return (TSPoint){ low, offset - document->lines[low] };
+}
+
+/**
+ * Return the point after inserting the bytes at the given point.
+ */
+
+static TSPoint point_after(TSPoint point, const char *bytes, uint32_t length) {
+  for (uint32_t i = 0; i < length; i++) {
+    if (bytes[i] == '\n') {
+      point.row++;
+      point.column = 0;
+    } else {
+      point.column++;
+    }
+  }
+  return point;
+}
+
+/**
+ * Return the context of the character at the offset in the complete input.
+ */
+
+static int document_context(const Document *document, uint32_t offset) {
+  TSNode node = ts_node_descendant_for_byte_range(ts_tree_root_node(document->reference),
+                                                  offset, offset + 1);
+
+  for (; !ts_node_is_null(node); node = ts_node_parent(node)) {
+    const char *type = ts_node_type(node);
+
+    if (strcmp(type, "heredoc_body") == 0 || strcmp(type, "heredoc_start") == 0) {
+      return CONTEXT_HEREDOC;
+    }
+    if (strcmp(type, "double_quoted_string") == 0) return CONTEXT_STRING;
+  }
+  return CONTEXT_CODE;
+}
+
+/**
+ * Return the length of the UTF-8 character at the offset.
+ */
+
+static uint32_t char_length(const BenchInput *input, uint32_t offset) {
+  uint32_t length = 1;
+
+  while (offset + length < input->length && (input->source[offset + length] & 0xC0) == 0x80) {
+    length++;
+  }
+  return length;
+}
+
+/**
+ * Apply the edit to the tree, reparse and record the latency and the
+ * characters read by the scanner. The old tree is replaced by the new one.
+ */
+
+static void reparse(TSParser *parser, TSTree **tree, const TSInputEdit *edit,
+                    const char *source, uint32_t length, EditStats *stats) {
+  ts_tree_edit(*tree, edit);
+#ifdef PUPPET_EDIT_STATS
+  tree_sitter_puppet_scanner_stats_reset();
+#endif
+
+  uint64_t start = bench_now_ns();
+  TSTree *new_tree = ts_parser_parse_string(parser, *tree, source, length);
+  uint64_t elapsed = bench_now_ns() - start;
+
+  ts_tree_delete(*tree);
+  *tree = new_tree;
+
+  if (stats->count == stats->capacity) {
+    stats->capacity = stats->capacity ? 2 * stats->capacity : 1024;
+    stats->latencies = realloc(stats->latencies, stats->capacity * sizeof(double));
+  }
+  stats->latencies[stats->count++] = (double)elapsed;
+
+#ifdef PUPPET_EDIT_STATS
+  uint64_t chars = tree_sitter_puppet_scanner_stats_chars();
+
+  stats->chars += chars;
+  if (chars > stats->max_chars) stats->max_chars = chars;
+#endif
+}
+
+/**
+ * Type the first characters of the input one at a time.
+ */
+
+static void replay_typing(TSParser *parser, const Document *document, size_t edits,
+                          EditStats stats[CONTEXT_COUNT]) {
+  const BenchInput *input = document->input;
+  char *buffer = malloc(input->length + 1);
+  TSTree *tree = ts_parser_parse_string(parser, NULL, "", 0);
+  TSPoint point = { 0, 0 };
+  uint32_t offset = 0;
+
+  for (size_t n = 0; n < edits && offset < input->length; n++) {
+    uint32_t length = char_length(input, offset);
+    TSPoint end = point_after(point, input->source + offset, length);
+    TSInputEdit edit = { offset, offset, offset + length, point, point, end };
+
+    memcpy(buffer + offset, input->source + offset, length);
+    reparse(parser, &tree, &edit, buffer, offset + length,
+            &stats[document_context(document, offset)]);
+    offset += length;
+    point = end;
+  }
+
+  ts_tree_delete(tree);
+  free(buffer);
+}
+
+/**
+ * Delete a random character and insert it again.
+ */
+
+static void replay_random(TSParser *parser, const Document *document, size_t edits,
+                          EditStats stats[CONTEXT_COUNT]) {
+  const BenchInput *input = document->input;
+  char *buffer = malloc(input->length + 1);
+  TSTree *tree = ts_parser_parse_string(parser, NULL, input->source, input->length);
+
+  if (input->length == 0) edits = 0;
+  memcpy(buffer, input->source, input->length);
+
+  for (size_t n = 0; n + 1 < edits; n += 2) {
+    uint32_t offset = (uint32_t)((uint64_t)rand() * input->length / ((uint64_t)RAND_MAX + 1));
+
+    while (offset > 0 && (input->source[offset] & 0xC0) == 0x80) offset--;
+
+    uint32_t length = char_length(input, offset);
+    TSPoint point = document_point(document, offset);
+    TSPoint end = point_after(point, input->source + offset, length);
+    EditStats *context = &stats[document_context(document, offset)];
+    TSInputEdit deletion = { offset, offset + length, offset, point, end, point };
+    TSInputEdit insertion = { offset, offset, offset + length, point, point, end };
+
+    memmove(buffer + offset, buffer + offset + length, input->length - offset - length);
+    reparse(parser, &tree, &deletion, buffer, input->length - length, context);
+
+    memmove(buffer + offset + length, buffer + offset, input->length - offset - length);
+    memcpy(buffer + offset, input->source + offset, length);
+    reparse(parser, &tree, &insertion, buffer, input->length, context);
+  }
+
+  ts_tree_delete(tree);
+  free(buffer);
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "Usage: %s [-e edits] [-s seed] [path ...]\n", program);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  BenchInputs inputs = {0};
+  EditStats stats[EDIT_KIND_COUNT][CONTEXT_COUNT] = {{{0}}};
+  size_t edits = 1000;
+  unsigned seed = 1;
+  int option;
+
+  while ((option = getopt(argc, argv, "e:s:h")) != -1) {
+    switch (option) {
+    case 'e':
+      if (atoi(optarg) < 2) usage(argv[0]);
+      edits = (size_t)atoi(optarg);
+      break;
+    case 's':
+      seed = (unsigned)strtoul(optarg, NULL, 10);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind == argc) {
+    if (!bench_inputs_add(&inputs, PUPPET_BENCH_CORPUS)) return 1;
+  }
+  for (int i = optind; i < argc; i++) {
+    if (!bench_inputs_add(&inputs, argv[i])) return 1;
+  }
+  if (inputs.size == 0) {
+    fprintf(stderr, "%s: no input files\n", argv[0]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+
+  ts_parser_set_language(parser, tree_sitter_puppet());
+  srand(seed);
+
+  for (size_t i = 0; i < inputs.size; i++) {
+    const BenchInput *input = &inputs.contents[i];
+    Document document = { input, malloc((input->length + 1) * sizeof(uint32_t)), 1, NULL };
+
+    document.lines[0] = 0;
+    for (uint32_t j = 0; j < input->length; j++) {
+      if (input->source[j] == '\n') document.lines[document.line_count++] = j + 1;
+    }
+    document.reference = ts_parser_parse_string(parser, NULL, input->source, input->length);
+
+    replay_typing(parser, &document, edits, stats[EDIT_TYPING]);
+    replay_random(parser, &document, edits, stats[EDIT_RANDOM]);
+
+    ts_tree_delete(document.reference);
+    free(document.lines);
+  }
+
+  printf("inputs: %zu (%llu bytes)\n\n", inputs.size,
+         (unsigned long long)bench_inputs_bytes(&inputs));
+#ifdef PUPPET_EDIT_STATS
+  printf("%-8s %-8s %8s %12s %12s\n", "edit", "context", "edits", "chars/edit", "max chars");
+#else
+  printf("%-8s %-8s %8s %10s %10s %10s\n", "edit", "context", "edits",
+         "p50 us", "p99 us", "max us");
+#endif
+
+  for (int kind = 0; kind < EDIT_KIND_COUNT; kind++) {
+    for (int context = 0; context < CONTEXT_COUNT; context++) {
+      EditStats *s = &stats[kind][context];
+
+      if (s->count == 0) continue;
+#ifdef PUPPET_EDIT_STATS
+      printf("%-8s %-8s %8zu %12.1f %12llu\n",
+             EDIT_KIND_NAMES[kind], CONTEXT_NAMES[context], s->count,
+             (double)s->chars / (double)s->count, (unsigned long long)s->max_chars);
+#else
+      printf("%-8s %-8s %8zu %10.1f %10.1f %10.1f\n",
+             EDIT_KIND_NAMES[kind], CONTEXT_NAMES[context], s->count,
+             bench_percentile(s->latencies, s->count, 50.0) / 1e3,
+             bench_percentile(s->latencies, s->count, 99.0) / 1e3,
+             bench_percentile(s->latencies, s->count, 100.0) / 1e3);
+#endif
+      free(s->latencies);
+    }
+  }
+
+  ts_parser_delete(parser);
+  bench_inputs_delete(&inputs);
+  return 0;
+}
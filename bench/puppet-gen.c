@@ -0,0 +1,613 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Synthetic manifest generator
+ *
+ * Usage: puppet-gen [-s seed] [-b bytes] [-d depth] [-m mix] [-l length]
+ *                   [-n lines] [-o file]
+ *
+ * Writes a Puppet manifest of at least the given size (a suffix of K, M or
+ * G is accepted). The output only depends on the options, so the same seed
+ * always produces the same manifest. The mix is a comma separated list of
+ * construct=weight pairs that sets the relative frequency of the top-level
+ * constructs, e.g. "resource=5,heredoc=2,regex=0". The depth limits the
+ * nesting of classes, defines, hashes and arrays. If a line length is
+ * given, the lines of heredocs have about this length and contain escapes
+ * and interpolations at regular intervals. The number of lines sets a fixed
+ * number of lines for every heredoc.
+ *
+ * The unterminated construct is a heredoc without an end tag. It makes the
+ * manifest invalid and has a weight of 0 unless it is given in the mix.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/**
+ * The constructs that the generator can emit. The order must be the same
+ * as in CONSTRUCT_NAMES.
+ */
+
+enum Construct {
+  CLASS,
+  DEFINE,
+  RESOURCE,
+  HASH,
+  ARRAY,
+  SELECTOR,
+  CHAIN,
+  STRING,
+  HEREDOC,
+  REGEX,
+  UNTERMINATED,
+  CONSTRUCT_COUNT,
+};
+
+static const char *CONSTRUCT_NAMES[CONSTRUCT_COUNT] = {
+  "class", "define", "resource", "hash", "array",
+  "selector", "chain", "string", "heredoc", "regex", "unterminated",
+};
+
+static const char *WORDS[] = {
+  "alpha", "apache", "backup", "config", "daemon", "data", "debian", "foo",
+  "bar", "group", "host", "limit", "mysql", "nginx", "ntp", "owner",
+  "package", "path", "port", "redhat", "server", "service", "site", "ssh",
+  "user", "vhost", "web", "zone",
+};
+
+#define WORD_COUNT (sizeof(WORDS) / sizeof(WORDS[0]))
+
+static const char *RESOURCE_TYPES[] = {
+  "file", "package", "service", "exec", "user", "group", "cron", "host",
+};
+
+#define RESOURCE_TYPE_COUNT (sizeof(RESOURCE_TYPES) / sizeof(RESOURCE_TYPES[0]))
+
+static const char *REFERENCE_TYPES[] = {
+  "File", "Package", "Service", "Exec",
+};
+
+#define REFERENCE_TYPE_COUNT (sizeof(REFERENCE_TYPES) / sizeof(REFERENCE_TYPES[0]))
+
+static const char *REGEXES[] = {
+  "/^web\\d+\\.example\\.com$/",
+  "/^(Debian|Ubuntu)$/",
+  "/\\A[a-z][a-z0-9_]*\\z/",
+  "/^\\/(usr|opt)\\/[^\\/]+#\\d*$/",
+  "/[[:alpha:]]{2,8}-\\w+/",
+};
+
+#define REGEX_COUNT (sizeof(REGEXES) / sizeof(REGEXES[0]))
+
+
+typedef struct {
+  FILE     *out;
+  uint64_t bytes;                 // number of bytes written so far
+  uint64_t rng;                   // state of the random number generator
+  uint64_t serial;                // used to create unique names
+  int      indent;
+  int      max_depth;
+  unsigned line_length;           // length of heredoc lines, 0 for short lines
+  unsigned heredoc_lines;         // lines per heredoc, 0 for a random number
+  unsigned weights[CONSTRUCT_COUNT];
+} Generator;
+
+
+/**
+ * SplitMix64: small, fast and completely deterministic.
+ */
+
+static uint64_t next_random(Generator *gen) {
+  uint64_t z = (gen->rng += 0x9e3779b97f4a7c15u);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+  return z ^ (z >> 31);
+}
+
+/**
+ * Return a random number in the range [low, high].
+ */
+
+static unsigned rand_range(Generator *gen, unsigned low, unsigned high) {
+  return low + (unsigned)(next_random(gen) % (high - low + 1));
+}
+
+static bool rand_chance(Generator *gen, unsigned percent) {
+  return rand_range(gen, 1, 100) <= percent;
+}
+
+static const char *rand_word(Generator *gen) {
+  return WORDS[rand_range(gen, 0, WORD_COUNT - 1)];
+}
+
+/**
+ * Output helpers that keep track of the number of bytes written.
+ */
+
+static void emit(Generator *gen, const char *format, ...) {
+  va_list args;
+
+  va_start(args, format);
+  int count = vfprintf(gen->out, format, args);
+  va_end(args);
+
+  if (count > 0) gen->bytes += (uint64_t)count;
+}
+
+static void emit_indent(Generator *gen) {
+  emit(gen, "%*s", 2 * gen->indent, "");
+}
+
+static void gen_statement(Generator *gen, int depth);
+static void gen_value(Generator *gen, int depth);
+
+
+static void gen_dq_string(Generator *gen) {
+  emit(gen, "\"%s ", rand_word(gen));
+  switch (rand_range(gen, 0, 3)) {
+  case 0: emit(gen, "${%s}", rand_word(gen)); break;
+  case 1: emit(gen, "$%s_%u", rand_word(gen), rand_range(gen, 1, 9)); break;
+  case 2: emit(gen, "${facts['os']['%s']}", rand_word(gen)); break;
+  case 3: emit(gen, "\\t\\\"%s\\\"", rand_word(gen)); break;
+  }
+  emit(gen, " %s\"", rand_word(gen));
+}
+
+static void gen_hash(Generator *gen, int depth) {
+  unsigned count = rand_range(gen, 1, 6);
+
+  emit(gen, "{\n");
+  gen->indent++;
+  for (unsigned i = 0; i < count; i++) {
+    emit_indent(gen);
+    emit(gen, "'%s_%u' => ", rand_word(gen), i);
+    gen_value(gen, depth + 1);
+    emit(gen, ",\n");
+  }
+  gen->indent--;
+  emit_indent(gen);
+  emit(gen, "}");
+}
+
+static void gen_array(Generator *gen, int depth) {
+  unsigned count = rand_range(gen, 1, 6);
+
+  emit(gen, "[");
+  for (unsigned i = 0; i < count; i++) {
+    if (i > 0) emit(gen, ", ");
+    gen_value(gen, depth + 1);
+  }
+  emit(gen, "]");
+}
+
+static void gen_selector(Generator *gen, int depth) {
+  unsigned count = rand_range(gen, 1, 4);
+
+  emit(gen, "$facts['os']['%s'] ? {\n", rand_word(gen));
+  gen->indent++;
+  for (unsigned i = 0; i < count; i++) {
+    emit_indent(gen);
+    if (rand_chance(gen, 30)) {
+      emit(gen, "%s", REGEXES[rand_range(gen, 0, REGEX_COUNT - 1)]);
+    } else {
+      emit(gen, "'%s'", rand_word(gen));
+    }
+    emit(gen, " => ");
+    gen_value(gen, depth + 1);
+    emit(gen, ",\n");
+  }
+  emit_indent(gen);
+  emit(gen, "default => undef,\n");
+  gen->indent--;
+  emit_indent(gen);
+  emit(gen, "}");
+}
+
+/**
+ * Emit a value. Nested values are only used below the maximum depth.
+ */
+
+static void gen_value(Generator *gen, int depth) {
+  unsigned kind = rand_range(gen, 0, (depth < gen->max_depth) ? 8 : 5);
+
+  switch (kind) {
+  case 0: emit(gen, "'%s'", rand_word(gen)); break;
+  case 1: gen_dq_string(gen); break;
+  case 2: emit(gen, "%u", rand_range(gen, 0, 65535)); break;
+  case 3: emit(gen, rand_chance(gen, 50) ? "true" : "false"); break;
+  case 4: emit(gen, "$%s", rand_word(gen)); break;
+  case 5: emit(gen, "%s['%s']",
+               REFERENCE_TYPES[rand_range(gen, 0, REFERENCE_TYPE_COUNT - 1)],
+               rand_word(gen)); break;
+  case 6: gen_hash(gen, depth); break;
+  case 7: gen_array(gen, depth); break;
+  case 8: gen_selector(gen, depth); break;
+  }
+}
+
+static void gen_resource(Generator *gen, int depth) {
+  unsigned count = rand_range(gen, 2, 12);
+
+  emit_indent(gen);
+  emit(gen, "%s { '%s_%llu':\n",
+       RESOURCE_TYPES[rand_range(gen, 0, RESOURCE_TYPE_COUNT - 1)],
+       rand_word(gen), (unsigned long long)gen->serial++);
+  gen->indent++;
+  for (unsigned i = 0; i < count; i++) {
+    emit_indent(gen);
+    emit(gen, "%s_%u => ", rand_word(gen), i);
+    gen_value(gen, depth);
+    emit(gen, ",\n");
+  }
+  gen->indent--;
+  emit_indent(gen);
+  emit(gen, "}\n");
+}
+
+static void gen_parameters(Generator *gen) {
+  unsigned count = rand_range(gen, 0, 4);
+
+  if (count == 0) return;
+
+  emit(gen, "(\n");
+  gen->indent++;
+  for (unsigned i = 0; i < count; i++) {
+    emit_indent(gen);
+    switch (rand_range(gen, 0, 2)) {
+    case 0: emit(gen, "String $%s_%u = '%s',\n", rand_word(gen), i, rand_word(gen)); break;
+    case 1: emit(gen, "Integer[0, 65535] $%s_%u = %u,\n", rand_word(gen), i,
+                 rand_range(gen, 0, 65535)); break;
+    case 2: emit(gen, "Optional[Hash] $%s_%u = undef,\n", rand_word(gen), i); break;
+    }
+  }
+  gen->indent--;
+  emit_indent(gen);
+  emit(gen, ") ");
+}
+
+/**
+ * Emit a class or a defined type with a body of nested statements.
+ */
+
+static void gen_definition(Generator *gen, int depth, const char *keyword) {
+  unsigned count = rand_range(gen, 1, 6);
+
+  emit_indent(gen);
+  emit(gen, "%s %s::%s_%llu ", keyword, rand_word(gen), rand_word(gen),
+       (unsigned long long)gen->serial++);
+  gen_parameters(gen);
+  emit(gen, "{\n");
+  gen->indent++;
+  for (unsigned i = 0; i < count; i++) {
+    gen_statement(gen, depth + 1);
+  }
+  gen->indent--;
+  emit_indent(gen);
+  emit(gen, "}\n");
+}
+
+static void gen_chain(Generator *gen) {
+  unsigned count = rand_range(gen, 2, 6);
+  static const char *arrows[] = { "->", "~>" };
+
+  emit_indent(gen);
+  for (unsigned i = 0; i < count; i++) {
+    if (i > 0) emit(gen, " %s ", arrows[rand_range(gen, 0, 1)]);
+    if (rand_chance(gen, 20)) {
+      emit(gen, "Class['%s::%s']", rand_word(gen), rand_word(gen));
+    } else {
+      emit(gen, "%s['%s_%u']",
+           REFERENCE_TYPES[rand_range(gen, 0, REFERENCE_TYPE_COUNT - 1)],
+           rand_word(gen), rand_range(gen, 0, 99));
+    }
+  }
+  emit(gen, "\n");
+}
+
+/**
+ * Emit a heredoc line of about the configured length. Every eight words an
+ * escape sequence and an interpolation are added.
+ */
+
+static void gen_long_line(Generator *gen) {
+  uint64_t end = gen->bytes + gen->line_length;
+
+  for (unsigned i = 0; gen->bytes < end; i++) {
+    switch (i % 8) {
+    case 3:  emit(gen, "%s\\n", rand_word(gen)); break;
+    case 7:  emit(gen, "${%s} ", rand_word(gen)); break;
+    default: emit(gen, "%s ", rand_word(gen)); break;
+    }
+  }
+}
+
+/**
+ * Emit a heredoc with escapes, interpolation and an indented end tag.
+ */
+
+static void gen_heredoc(Generator *gen) {
+  unsigned count = rand_range(gen, 1, 12);
+
+  if (gen->heredoc_lines) count = gen->heredoc_lines;
+  bool interpolate = gen->line_length || rand_chance(gen, 60);
+  bool escapes = gen->line_length || rand_chance(gen, 50);
+  const char *tag = rand_chance(gen, 50) ? "END" : "EOT";
+
+  emit_indent(gen);
+  emit(gen, "$text_%llu = @(%s%s%s%s)\n", (unsigned long long)gen->serial++,
+       interpolate ? "\"" : "", tag, interpolate ? "\"" : "",
+       escapes ? "/nt$L" : "");
+  for (unsigned i = 0; i < count; i++) {
+    emit_indent(gen);
+    if (gen->line_length) {
+      emit(gen, "  ");
+      gen_long_line(gen);
+      emit(gen, "\n");
+      continue;
+    }
+    emit(gen, "  %s %s", rand_word(gen), rand_word(gen));
+    if (interpolate && rand_chance(gen, 40)) {
+      emit(gen, " ${%s} and $%s", rand_word(gen), rand_word(gen));
+    }
+    if (escapes && rand_chance(gen, 40)) {
+      emit(gen, "\\t\\$%s\\n", rand_word(gen));
+    }
+    if (escapes && rand_chance(gen, 10)) {
+      emit(gen, " \\");   // escaped newline
+    }
+    emit(gen, "\n");
+  }
+  emit_indent(gen);
+  emit(gen, "  | %s\n", tag);
+}
+
+static void gen_regex(Generator *gen, int depth) {
+  const char *regex = REGEXES[rand_range(gen, 0, REGEX_COUNT - 1)];
+
+  emit_indent(gen);
+  if (depth == 0 && rand_chance(gen, 50)) {
+    emit(gen, "node %s {\n", regex);
+    gen->indent++;
+    emit_indent(gen);
+    emit(gen, "include role::%s\n", rand_word(gen));
+  } else {
+    emit(gen, "if $%s =~ %s {\n", rand_word(gen), regex);
+    gen->indent++;
+    emit_indent(gen);
+    emit(gen, "notice($%s !~ %s)\n", rand_word(gen),
+         REGEXES[rand_range(gen, 0, REGEX_COUNT - 1)]);
+  }
+  gen->indent--;
+  emit_indent(gen);
+  emit(gen, "}\n");
+}
+
+/**
+ * Emit a heredoc tag without a matching end tag.
+ */
+
+static void gen_unterminated(Generator *gen) {
+  unsigned long long serial = (unsigned long long)gen->serial++;
+
+  emit_indent(gen);
+  emit(gen, "$text_%llu = @(MISSING_%llu)\n", serial, serial);
+  emit_indent(gen);
+  emit(gen, "  %s %s\n", rand_word(gen), rand_word(gen));
+}
+
+/**
+ * Pick a construct according to the weights and emit it.
+ */
+
+static void gen_statement(Generator *gen, int depth) {
+  unsigned total = 0;
+  unsigned weights[CONSTRUCT_COUNT];
+
+  for (int i = 0; i < CONSTRUCT_COUNT; i++) {
+    weights[i] = gen->weights[i];
+    // Limit the nesting of definitions
+    if ((i == CLASS || i == DEFINE) && depth >= gen->max_depth) weights[i] = 0;
+    total += weights[i];
+  }
+  if (total == 0) {
+    weights[RESOURCE] = total = 1;
+  }
+
+  unsigned pick = rand_range(gen, 0, total - 1);
+  int construct = 0;
+  while (pick >= weights[construct]) {
+    pick -= weights[construct++];
+  }
+
+  switch (construct) {
+  case CLASS:
+    gen_definition(gen, depth, "class");
+    break;
+  case DEFINE:
+    gen_definition(gen, depth, "define");
+    break;
+  case RESOURCE:
+    gen_resource(gen, depth);
+    break;
+  case HASH:
+    emit_indent(gen);
+    emit(gen, "$hash_%llu = ", (unsigned long long)gen->serial++);
+    gen_hash(gen, depth);
+    emit(gen, "\n");
+    break;
+  case ARRAY:
+    emit_indent(gen);
+    emit(gen, "$array_%llu = ", (unsigned long long)gen->serial++);
+    gen_array(gen, depth);
+    emit(gen, "\n");
+    break;
+  case SELECTOR:
+    emit_indent(gen);
+    emit(gen, "$selected_%llu = ", (unsigned long long)gen->serial++);
+    gen_selector(gen, depth);
+    emit(gen, "\n");
+    break;
+  case CHAIN:
+    gen_chain(gen);
+    break;
+  case STRING:
+    emit_indent(gen);
+    emit(gen, "$message_%llu = ", (unsigned long long)gen->serial++);
+    gen_dq_string(gen);
+    emit(gen, "\n");
+    break;
+  case HEREDOC:
+    gen_heredoc(gen);
+    break;
+  case REGEX:
+    gen_regex(gen, depth);
+    break;
+  case UNTERMINATED:
+    gen_unterminated(gen);
+    break;
+  }
+}
+
+/**
+ * Parse a size with an optional K, M or G suffix (powers of 1024).
+ */
+
+static bool parse_size(const char *text, uint64_t *size) {
+  char *end;
+  unsigned long long value = strtoull(text, &end, 10);
+
+  switch (*end) {
+  case 'k': case 'K': value <<= 10; end++; break;
+  case 'm': case 'M': value <<= 20; end++; break;
+  case 'g': case 'G': value <<= 30; end++; break;
+  }
+
+  *size = value;
+  return (end != text) && (*end == '\0');
+}
+
+/**
+ * Parse the construct mix: a comma separated list of name=weight pairs.
+ */
+
+static bool parse_mix(const char *text, unsigned weights[CONSTRUCT_COUNT]) {
+  while (*text) {
+    size_t length = strcspn(text, "=");
+    int construct;
+
+    for (construct = 0; construct < CONSTRUCT_COUNT; construct++) {
+      if (strlen(CONSTRUCT_NAMES[construct]) == length &&
+          strncmp(CONSTRUCT_NAMES[construct], text, length) == 0) break;
+    }
+    if (construct == CONSTRUCT_COUNT || text[length] != '=') return false;
+
+    char *end;
+    weights[construct] = (unsigned)strtoul(text + length + 1, &end, 10);
+    if (*end == ',') end++;
+    else if (*end != '\0') return false;
+    text = end;
+  }
+  return true;
+}
+
+static void usage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [-s seed] [-b bytes] [-d depth] [-m mix] [-l length]\n"
+          "       [-n lines] [-o file]\n"
+          "Constructs for the mix:", program);
+  for (int i = 0; i < CONSTRUCT_COUNT; i++) {
+    fprintf(stderr, " %s", CONSTRUCT_NAMES[i]);
+  }
+  fprintf(stderr, "\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  Generator gen = { .out = stdout, .max_depth = 3 };
+  uint64_t target = 64 << 10;
+  int option;
+
+  for (int i = 0; i < CONSTRUCT_COUNT; i++) {
+    gen.weights[i] = 1;
+  }
+  gen.weights[RESOURCE] = 4;
+  gen.weights[UNTERMINATED] = 0;
+
+  while ((option = getopt(argc, argv, "s:b:d:m:l:n:o:h")) != -1) {
+    switch (option) {
+    case 's':
+      gen.rng = strtoull(optarg, NULL, 0);
+      break;
+    case 'b':
+      if (!parse_size(optarg, &target)) usage(argv[0]);
+      break;
+    case 'd':
+      gen.max_depth = atoi(optarg);
+      break;
+    case 'm':
+      if (!parse_mix(optarg, gen.weights)) usage(argv[0]);
+      break;
+    case 'l':
+      gen.line_length = (unsigned)atoi(optarg);
+      break;
+    case 'n':
+      gen.heredoc_lines = (unsigned)atoi(optarg);
+      break;
+    case 'o':
+      if (!(gen.out = fopen(optarg, "w"))) {
+        perror(optarg);
+        return 1;
+      }
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  emit(&gen, "# Generated by puppet-gen\n");
+  while (gen.bytes < target) {
+    gen_statement(&gen, 0);
+  }
+
+  if (fclose(gen.out) != 0) {
+    perror("puppet-gen");
+    return 1;
+  }
+  return 0;
+}
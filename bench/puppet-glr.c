@@ -0,0 +1,345 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * GLR fork census
+ *
+ * Usage: puppet-glr [-n count] [-j file] [path ...]
+ *
+ * Parses the given manifests, corpus files or directories (default: the
+ * test corpus) with a parser logger and counts how often the parser splits
+ * its stack into several versions. The counts are derived from the parse
+ * log of the tree-sitter runtime:
+ *
+ * - splits:    increase of the version count between two "process" steps
+ * - merges:    decrease of the version count (versions merged or removed)
+ * - max:       the maximum number of versions at a time
+ * - discarded: alternative subtrees dropped by the ambiguity resolution
+ *              ("select_*" messages)
+ *
+ * A split is attributed to the rules reduced in the step before it, and
+ * discarded subtrees to the rule of the losing subtree. The reductions done
+ * while more than one version exists show which rules are parsed twice.
+ * The report lists the files and rules with the most splits; the number
+ * of entries is set with -n. Use -j to also write the results as JSON.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+#include "util.h"
+
+#ifndef PUPPET_BENCH_CORPUS
+#define PUPPET_BENCH_CORPUS "test/corpus"
+#endif
+
+#define MAX_NAME_LENGTH 64
+#define MAX_PENDING_RULES 16
+
+
+typedef struct {
+  uint64_t steps;                 // number of process steps
+  uint64_t forked_steps;          // steps with more than one version
+  uint64_t splits;
+  uint64_t merges;
+  uint64_t discarded;
+  unsigned max_versions;
+} GlrCounts;
+
+typedef struct {
+  char     name[MAX_NAME_LENGTH];
+  uint64_t splits;
+  uint64_t forked_reductions;
+  uint64_t discarded;
+} RuleCounts;
+
+typedef struct {
+  GlrCounts counts;               // counts of the current input
+  unsigned  version_count;        // version count of the last process step
+  size_t    pending[MAX_PENDING_RULES];
+  unsigned  pending_count;        // rules reduced since the last process step
+  RuleCounts *rules;
+  size_t    rule_count;
+  size_t    rule_capacity;
+} Census;
+
+typedef struct {
+  const char *name;
+  GlrCounts  counts;
+} FileResult;
+
+
+/**
+ * Return the index of the rule with the given name. The name ends at the
+ * first comma or blank.
+ */
+
+static size_t census_rule(Census *census, const char *name) {
+  size_t length = strcspn(name, ", ");
+
+  if (length >= MAX_NAME_LENGTH) length = MAX_NAME_LENGTH - 1;
+
+  for (size_t i = 0; i < census->rule_count; i++) {
+    if (strncmp(census->rules[i].name, name, length) == 0 &&
+        census->rules[i].name[length] == '\0') {
+      return i;
+    }
+  }
+
+  if (census->rule_count == census->rule_capacity) {
+    census->rule_capacity = census->rule_capacity ? 2 * census->rule_capacity : 64;
+    census->rules = realloc(census->rules, census->rule_capacity * sizeof(RuleCounts));
+  }
+
+  RuleCounts *rule = &census->rules[census->rule_count];
+  memset(rule, 0, sizeof(RuleCounts));
+  memcpy(rule->name, name, length);
+  return census->rule_count++;
+}
+
+static void census_log(void *payload, TSLogType log_type, const char *message) {
+  Census *census = payload;
+  unsigned version, version_count;
+  const char *value;
+
+  if (log_type != TSLogTypeParse) return;
+
+  if (sscanf(message, "process version:%u, version_count:%u", &version, &version_count) == 2) {
+    GlrCounts *counts = &census->counts;
+
+    counts->steps++;
+    if (version_count > 1) counts->forked_steps++;
+    if (version_count > counts->max_versions) counts->max_versions = version_count;
+
+    if (version_count > census->version_count) {
+      unsigned splits = version_count - census->version_count;
+
+      counts->splits += splits;
+      for (unsigned i = 0; i < census->pending_count; i++) {
+        census->rules[census->pending[i]].splits += splits;
+      }
+    } else if (version_count < census->version_count) {
+      counts->merges += census->version_count - version_count;
+    }
+
+    census->version_count = version_count;
+    census->pending_count = 0;
+    return;
+  }
+
+  if (strncmp(message, "reduce sym:", 11) == 0) {
+    size_t rule = census_rule(census, message + 11);
+
+    if (census->version_count > 1) census->rules[rule].forked_reductions++;
+    if (census->pending_count < MAX_PENDING_RULES) {
+      census->pending[census->pending_count++] = rule;
+    }
+    return;
+  }
+
+  if (strncmp(message, "select_", 7) == 0) {
+    census->counts.discarded++;
+    if ((value = strstr(message, "over_symbol:")) != NULL) {
+      census->rules[census_rule(census, value + 12)].discarded++;
+    }
+  }
+}
+
+static int compare_files(const void *a, const void *b) {
+  const FileResult *x = a, *y = b;
+
+  if (x->counts.splits != y->counts.splits) return x->counts.splits < y->counts.splits ? 1 : -1;
+  return (int)y->counts.max_versions - (int)x->counts.max_versions;
+}
+
+static int compare_rules(const void *a, const void *b) {
+  const RuleCounts *x = a, *y = b;
+
+  if (x->splits != y->splits) return x->splits < y->splits ? 1 : -1;
+  if (x->forked_reductions != y->forked_reductions) {
+    return x->forked_reductions < y->forked_reductions ? 1 : -1;
+  }
+  return strcmp(x->name, y->name);
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "Usage: %s [-n count] [-j file] [path ...]\n", program);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  BenchInputs inputs = {0};
+  Census census = {0};
+  const char *json_path = NULL;
+  size_t count = 20;
+  int option;
+
+  while ((option = getopt(argc, argv, "n:j:h")) != -1) {
+    switch (option) {
+    case 'n':
+      if (atoi(optarg) < 1) usage(argv[0]);
+      count = (size_t)atoi(optarg);
+      break;
+    case 'j':
+      json_path = optarg;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind == argc) {
+    if (!bench_inputs_add(&inputs, PUPPET_BENCH_CORPUS)) return 1;
+  }
+  for (int i = optind; i < argc; i++) {
+    if (!bench_inputs_add(&inputs, argv[i])) return 1;
+  }
+  if (inputs.size == 0) {
+    fprintf(stderr, "%s: no input files\n", argv[0]);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_puppet());
+  ts_parser_set_logger(parser, (TSLogger){ &census, census_log });
+
+  FileResult *files = calloc(inputs.size, sizeof(FileResult));
+  GlrCounts total = {0};
+  size_t forked_files = 0;
+
+  for (size_t i = 0; i < inputs.size; i++) {
+    BenchInput *input = &inputs.contents[i];
+
+    memset(&census.counts, 0, sizeof(GlrCounts));
+    census.version_count = 1;
+    census.pending_count = 0;
+
+    TSTree *tree = ts_parser_parse_string(parser, NULL, input->source, input->length);
+    ts_tree_delete(tree);
+
+    files[i].name = input->name;
+    files[i].counts = census.counts;
+
+    total.steps += census.counts.steps;
+    total.forked_steps += census.counts.forked_steps;
+    total.splits += census.counts.splits;
+    total.merges += census.counts.merges;
+    total.discarded += census.counts.discarded;
+    if (census.counts.max_versions > total.max_versions) {
+      total.max_versions = census.counts.max_versions;
+    }
+    if (census.counts.splits > 0) forked_files++;
+  }
+
+  qsort(files, inputs.size, sizeof(FileResult), compare_files);
+  qsort(census.rules, census.rule_count, sizeof(RuleCounts), compare_rules);
+
+  printf("inputs:    %zu (%llu bytes, %zu with splits)\n", inputs.size,
+         (unsigned long long)bench_inputs_bytes(&inputs), forked_files);
+  printf("steps:     %llu (%llu with more than one version)\n",
+         (unsigned long long)total.steps, (unsigned long long)total.forked_steps);
+  printf("splits:    %llu\n", (unsigned long long)total.splits);
+  printf("merges:    %llu\n", (unsigned long long)total.merges);
+  printf("discarded: %llu\n", (unsigned long long)total.discarded);
+  printf("max:       %u versions\n", total.max_versions);
+
+  printf("\n%10s %10s %10s %5s  %s\n", "splits", "merges", "discarded", "max", "file");
+  for (size_t i = 0; i < inputs.size && i < count && files[i].counts.splits > 0; i++) {
+    printf("%10llu %10llu %10llu %5u  %s\n",
+           (unsigned long long)files[i].counts.splits,
+           (unsigned long long)files[i].counts.merges,
+           (unsigned long long)files[i].counts.discarded,
+           files[i].counts.max_versions, files[i].name);
+  }
+
+  printf("\n%10s %10s %10s  %s\n", "splits", "forked", "discarded", "rule");
+  for (size_t i = 0; i < census.rule_count && i < count; i++) {
+    RuleCounts *rule = &census.rules[i];
+
+    if (rule->splits == 0 && rule->forked_reductions == 0 && rule->discarded == 0) break;
+    printf("%10llu %10llu %10llu  %s\n",
+           (unsigned long long)rule->splits,
+           (unsigned long long)rule->forked_reductions,
+           (unsigned long long)rule->discarded, rule->name);
+  }
+
+  if (json_path) {
+    FILE *json = strcmp(json_path, "-") ? fopen(json_path, "w") : stdout;
+
+    if (!json) {
+      perror(json_path);
+      return 1;
+    }
+
+    fprintf(json, "{\n  \"bytes\": %llu,\n",
+            (unsigned long long)bench_inputs_bytes(&inputs));
+    fprintf(json, "  \"steps\": %llu,\n", (unsigned long long)total.steps);
+    fprintf(json, "  \"forked_steps\": %llu,\n", (unsigned long long)total.forked_steps);
+    fprintf(json, "  \"splits\": %llu,\n", (unsigned long long)total.splits);
+    fprintf(json, "  \"merges\": %llu,\n", (unsigned long long)total.merges);
+    fprintf(json, "  \"discarded\": %llu,\n", (unsigned long long)total.discarded);
+    fprintf(json, "  \"max_versions\": %u,\n", total.max_versions);
+    fprintf(json, "  \"inputs\": [");
+    for (size_t i = 0; i < inputs.size; i++) {
+      fprintf(json, "%s\n    {\"name\": ", i ? "," : "");
+      bench_json_string(json, files[i].name);
+      fprintf(json, ", \"splits\": %llu, \"merges\": %llu, \"discarded\": %llu, \"max_versions\": %u}",
+              (unsigned long long)files[i].counts.splits,
+              (unsigned long long)files[i].counts.merges,
+              (unsigned long long)files[i].counts.discarded,
+              files[i].counts.max_versions);
+    }
+    fprintf(json, "\n  ],\n  \"rules\": [");
+    for (size_t i = 0; i < census.rule_count; i++) {
+      fprintf(json, "%s\n    {\"name\": ", i ? "," : "");
+      bench_json_string(json, census.rules[i].name);
+      fprintf(json, ", \"splits\": %llu, \"forked_reductions\": %llu, \"discarded\": %llu}",
+              (unsigned long long)census.rules[i].splits,
+              (unsigned long long)census.rules[i].forked_reductions,
+              (unsigned long long)census.rules[i].discarded);
+    }
+    fprintf(json, "\n  ]\n}\n");
+
+    if (json != stdout) fclose(json);
+  }
+
+  free(files);
+  free(census.rules);
+  ts_parser_delete(parser);
+  bench_inputs_delete(&inputs);
+
+  return 0;
+}
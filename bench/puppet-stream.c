@@ -0,0 +1,329 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Streaming parse benchmark
+ *
+ * Usage: puppet-stream [-m mode] [-s chunk_size] [-n iterations] [-c] path
+ *
+ * Parses a manifest with the given mode: 'buffer' reads the complete file
+ * into memory and parses the buffer, 'pread' and 'mmap' parse the file
+ * through a TSPuppetStream from tree_sitter/tree-sitter-puppet-stream.h
+ * with windows of the given size (default 64K). The time includes reading
+ * the file. The peak RSS is the maximum of the process, so a single mode is
+ * measured in a process of its own.
+ *
+ * The mode 'all' (the default) parses the manifest with every mode and
+ * checks that the streamed trees are the same as the tree of the buffer:
+ * every node must have the same symbol, byte offsets and children. The
+ * program fails if a tree differs. The option -c writes the results as CSV
+ * rows without a header.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet-stream.h>
+
+#include "util.h"
+
+
+typedef enum { MODE_BUFFER, MODE_PREAD, MODE_MMAP, MODE_ALL } Mode;
+
+static const char *mode_names[] = { "buffer", "pread", "mmap", "all" };
+
+
+/**
+ * Read the complete file into a newly allocated buffer.
+ */
+
+static char *read_file(const char *path, uint32_t *length) {
+  FILE *file = fopen(path, "rb");
+  char *buffer = NULL;
+  long size;
+
+  if (!file) return NULL;
+  if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 && size < UINT32_MAX &&
+      fseek(file, 0, SEEK_SET) == 0) {
+    buffer = malloc(size ? (size_t)size : 1);
+    if (buffer && fread(buffer, 1, (size_t)size, file) != (size_t)size) {
+      free(buffer);
+      buffer = NULL;
+    }
+    *length = (uint32_t)size;
+  }
+  fclose(file);
+  return buffer;
+}
+
+/**
+ * Parse the file with the mode and return the tree or NULL.
+ */
+
+static TSTree *parse_file(TSParser *parser, const char *path, Mode mode, uint32_t chunk_size) {
+  TSTree *tree = NULL;
+
+  if (mode == MODE_BUFFER) {
+    uint32_t length = 0;
+    char *source = read_file(path, &length);
+
+    if (!source) {
+      perror(path);
+      return NULL;
+    }
+    tree = ts_parser_parse_string(parser, NULL, source, length);
+    free(source);
+  } else {
+    TSPuppetStream stream;
+
+    if (!tree_sitter_puppet_stream_open(&stream, path, chunk_size,
+                                        mode == MODE_MMAP ? TSPuppetStreamMap : TSPuppetStreamRead)) {
+      perror(path);
+      return NULL;
+    }
+    tree = tree_sitter_puppet_stream_parse(parser, NULL, &stream);
+    if (!tree && stream.error != 0) {
+      fprintf(stderr, "%s: %s\n", path, strerror(stream.error));
+    }
+    tree_sitter_puppet_stream_close(&stream);
+  }
+
+  return tree;
+}
+
+/**
+ * Count the nodes of a tree.
+ */
+
+static uint64_t count_nodes(TSTree *tree) {
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  uint64_t count = 1;
+
+  for (;;) {
+    if (ts_tree_cursor_goto_first_child(&cursor) || ts_tree_cursor_goto_next_sibling(&cursor)) {
+      count++;
+      continue;
+    }
+
+    bool next = false;
+
+    while (!next && ts_tree_cursor_goto_parent(&cursor)) {
+      if (ts_tree_cursor_goto_next_sibling(&cursor)) {
+        count++;
+        next = true;
+      }
+    }
+    if (!next) break;
+  }
+
+  ts_tree_cursor_delete(&cursor);
+  return count;
+}
+
+/**
+ * Compare two trees. Return false and print the position of the first
+ * difference if they are not the same.
+ */
+
+static bool compare_trees(const char *name, const char *mode, TSTree *expected, TSTree *actual) {
+  TSTreeCursor expected_cursor = ts_tree_cursor_new(ts_tree_root_node(expected));
+  TSTreeCursor actual_cursor = ts_tree_cursor_new(ts_tree_root_node(actual));
+  bool same = true;
+
+  for (;;) {
+    TSNode a = ts_tree_cursor_current_node(&expected_cursor);
+    TSNode b = ts_tree_cursor_current_node(&actual_cursor);
+
+    if (ts_node_symbol(a) != ts_node_symbol(b) ||
+        ts_node_start_byte(a) != ts_node_start_byte(b) ||
+        ts_node_end_byte(a) != ts_node_end_byte(b) ||
+        ts_node_child_count(a) != ts_node_child_count(b)) {
+      TSPoint point = ts_node_start_point(a);
+
+      fprintf(stderr, "%s:%u:%u: %s differs from the %s parse (%s)\n", name,
+              point.row + 1, point.column + 1, ts_node_type(a), mode, ts_node_type(b));
+      same = false;
+      break;
+    }
+
+    // Both cursors have the same shape, so they move in lockstep
+    if (ts_tree_cursor_goto_first_child(&expected_cursor)) {
+      ts_tree_cursor_goto_first_child(&actual_cursor);
+      continue;
+    }
+
+    bool next = false;
+
+    while (!next) {
+      if (ts_tree_cursor_goto_next_sibling(&expected_cursor)) {
+        ts_tree_cursor_goto_next_sibling(&actual_cursor);
+        next = true;
+      } else if (ts_tree_cursor_goto_parent(&expected_cursor)) {
+        ts_tree_cursor_goto_parent(&actual_cursor);
+      } else {
+        break;
+      }
+    }
+    if (!next) break;
+  }
+
+  ts_tree_cursor_delete(&expected_cursor);
+  ts_tree_cursor_delete(&actual_cursor);
+  return same;
+}
+
+/**
+ * Parse a size with an optional K or M suffix (powers of 1024).
+ */
+
+static bool parse_size(const char *text, uint64_t *size) {
+  char *end;
+  unsigned long long value = strtoull(text, &end, 10);
+
+  switch (*end) {
+  case 'k': case 'K': value <<= 10; end++; break;
+  case 'm': case 'M': value <<= 20; end++; break;
+  }
+
+  *size = value;
+  return (end != text) && (*end == '\0');
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "Usage: %s [-m buffer|pread|mmap|all] [-s chunk_size] [-n iterations] [-c] path\n",
+          program);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  Mode mode = MODE_ALL;
+  uint64_t chunk_size = TREE_SITTER_PUPPET_STREAM_CHUNK_SIZE;
+  int iterations = 3;
+  bool csv = false;
+  int option, failures = 0;
+
+  while ((option = getopt(argc, argv, "m:s:n:ch")) != -1) {
+    switch (option) {
+    case 'm':
+      for (mode = MODE_BUFFER; mode <= MODE_ALL; mode++) {
+        if (strcmp(optarg, mode_names[mode]) == 0) break;
+      }
+      if (mode > MODE_ALL) usage(argv[0]);
+      break;
+    case 's':
+      if (!parse_size(optarg, &chunk_size) || chunk_size == 0 || chunk_size > UINT32_MAX) {
+        usage(argv[0]);
+      }
+      break;
+    case 'n':
+      iterations = atoi(optarg);
+      if (iterations < 1) usage(argv[0]);
+      break;
+    case 'c':
+      csv = true;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind + 1 != argc) usage(argv[0]);
+
+  const char *path = argv[optind];
+  Mode first = (mode == MODE_ALL) ? MODE_BUFFER : mode;
+  Mode last = (mode == MODE_ALL) ? MODE_MMAP : mode;
+  TSParser *parser = ts_parser_new();
+  TSTree *reference = NULL;
+  struct stat status;
+
+  if (stat(path, &status) != 0) {
+    perror(path);
+    return 1;
+  }
+
+  ts_parser_set_language(parser, tree_sitter_puppet());
+
+  if (!csv) {
+    printf("%-8s %12s %10s %10s %10s %12s %12s\n", "mode", "bytes", "chunk", "ms", "MB/s",
+           "nodes", "peak RSS kB");
+  }
+
+  for (Mode m = first; m <= last; m++) {
+    uint64_t best = UINT64_MAX;
+    TSTree *tree = NULL;
+
+    for (int n = 0; n < iterations; n++) {
+      uint64_t start = bench_now_ns();
+
+      if (tree) ts_tree_delete(tree);
+      tree = parse_file(parser, path, m, (uint32_t)chunk_size);
+      if (!tree) break;
+
+      uint64_t end = bench_now_ns();
+
+      if (end - start < best) best = end - start;
+    }
+
+    if (!tree) {
+      failures++;
+      continue;
+    }
+
+    uint32_t bytes = (uint32_t)status.st_size;
+    double mb_per_second = (double)bytes / (1024.0 * 1024.0) / ((double)best / 1e9);
+    uint32_t chunk = (m == MODE_BUFFER) ? bytes : (uint32_t)chunk_size;
+    // The peak RSS of the process only belongs to a single mode
+    long rss = (mode == MODE_ALL) ? 0 : bench_peak_rss_kb();
+
+    if (csv) {
+      printf("%s,%u,%u,%.2f,%llu,%ld\n", mode_names[m], bytes, chunk, mb_per_second,
+             (unsigned long long)count_nodes(tree), rss);
+    } else {
+      printf("%-8s %12u %10u %10.2f %10.2f %12llu %12ld\n", mode_names[m], bytes, chunk,
+             (double)best / 1e6, mb_per_second, (unsigned long long)count_nodes(tree), rss);
+    }
+
+    if (!reference) {
+      reference = tree;
+    } else {
+      if (!compare_trees(path, mode_names[m], reference, tree)) failures++;
+      ts_tree_delete(tree);
+    }
+  }
+
+  if (reference) ts_tree_delete(reference);
+  ts_parser_delete(parser);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,256 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Multi-threaded parse benchmark
+ *
+ * Usage: puppet-threads [-t threads] [-n iterations] [path ...]
+ *
+ * Parses the inputs (default: the test corpus) on 1, 2, 4, ... up to the
+ * given number of threads (default: the number of online processors). Each
+ * thread has its own parser and parses all inputs the given number of
+ * times. The language is shared by all threads. For every thread count the
+ * total throughput, the speedup over a single thread and the efficiency
+ * (speedup per thread) are reported, together with the allocations per
+ * parsed MB. A throughput that doesn't grow with the threads shows
+ * contention, for example in the allocator.
+ *
+ * In the first iteration every thread compares its trees with the trees of
+ * a single-threaded parse, so the program also works as a stress test. It
+ * fails if a tree differs. Build with -DPUPPET_TSAN=ON to run it with
+ * ThreadSanitizer.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+#include "util.h"
+
+#ifndef PUPPET_BENCH_CORPUS
+#define PUPPET_BENCH_CORPUS "test/corpus"
+#endif
+
+
+typedef struct {
+  const BenchInputs *inputs;
+  char     **expected;            // the tree of every input as S-expression
+  int      iterations;
+  size_t   mismatches;
+  uint64_t allocations;
+} Worker;
+
+static _Thread_local uint64_t allocation_count;
+
+
+/**
+ * Allocation functions for tree-sitter that count the allocations. The
+ * counters are per thread, so counting adds no contention of its own.
+ */
+
+static void *counting_malloc(size_t size) {
+  allocation_count++;
+  return malloc(size);
+}
+
+static void *counting_calloc(size_t count, size_t size) {
+  allocation_count++;
+  return calloc(count, size);
+}
+
+static void *counting_realloc(void *ptr, size_t size) {
+  allocation_count++;
+  return realloc(ptr, size);
+}
+
+static void *worker_run(void *payload) {
+  Worker *worker = payload;
+  const BenchInputs *inputs = worker->inputs;
+  TSParser *parser = ts_parser_new();
+
+  ts_parser_set_language(parser, tree_sitter_puppet());
+  allocation_count = 0;
+
+  for (int n = 0; n < worker->iterations; n++) {
+    for (size_t i = 0; i < inputs->size; i++) {
+      const BenchInput *input = &inputs->contents[i];
+      TSTree *tree = ts_parser_parse_string(parser, NULL, input->source, input->length);
+
+      if (n == 0) {
+        char *string = ts_node_string(ts_tree_root_node(tree));
+
+        if (strcmp(string, worker->expected[i]) != 0) {
+          fprintf(stderr, "%s: tree differs from the single-threaded parse\n", input->name);
+          worker->mismatches++;
+        }
+        free(string);
+      }
+      ts_tree_delete(tree);
+    }
+  }
+
+  ts_parser_delete(parser);
+  worker->allocations = allocation_count;
+  return NULL;
+}
+
+/**
+ * Parse the inputs on the given number of threads and return the wall
+ * clock time in nanoseconds or 0 if a thread can't be started.
+ */
+
+static uint64_t run_threads(Worker *workers, int threads) {
+  pthread_t *ids = calloc((size_t)threads, sizeof(pthread_t));
+  uint64_t start = bench_now_ns();
+  int started;
+
+  for (started = 0; started < threads; started++) {
+    if (pthread_create(&ids[started], NULL, worker_run, &workers[started]) != 0) break;
+  }
+  for (int i = 0; i < started; i++) {
+    pthread_join(ids[i], NULL);
+  }
+
+  uint64_t elapsed = bench_now_ns() - start;
+
+  free(ids);
+  return (started == threads) ? elapsed : 0;
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "Usage: %s [-t threads] [-n iterations] [path ...]\n", program);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  BenchInputs inputs = {0};
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+  int max_threads = processors > 0 ? (int)processors : 1;
+  int iterations = 10;
+  int option;
+
+  while ((option = getopt(argc, argv, "t:n:h")) != -1) {
+    switch (option) {
+    case 't':
+      max_threads = atoi(optarg);
+      if (max_threads < 1) usage(argv[0]);
+      break;
+    case 'n':
+      iterations = atoi(optarg);
+      if (iterations < 1) usage(argv[0]);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind == argc) {
+    if (!bench_inputs_add(&inputs, PUPPET_BENCH_CORPUS)) return 1;
+  }
+  for (int i = optind; i < argc; i++) {
+    if (!bench_inputs_add(&inputs, argv[i])) return 1;
+  }
+  if (inputs.size == 0) {
+    fprintf(stderr, "%s: no input files\n", argv[0]);
+    return 1;
+  }
+
+  ts_set_allocator(counting_malloc, counting_calloc, counting_realloc, free);
+
+  // The reference trees of a single-threaded parse
+  char **expected = malloc(inputs.size * sizeof(char *));
+  TSParser *parser = ts_parser_new();
+
+  ts_parser_set_language(parser, tree_sitter_puppet());
+  for (size_t i = 0; i < inputs.size; i++) {
+    BenchInput *input = &inputs.contents[i];
+    TSTree *tree = ts_parser_parse_string(parser, NULL, input->source, input->length);
+
+    expected[i] = ts_node_string(ts_tree_root_node(tree));
+    ts_tree_delete(tree);
+  }
+  ts_parser_delete(parser);
+
+  uint64_t bytes = bench_inputs_bytes(&inputs);
+  Worker *workers = calloc((size_t)max_threads, sizeof(Worker));
+  double single = 0;
+  size_t mismatches = 0;
+
+  printf("inputs:     %zu (%llu bytes)\n", inputs.size, (unsigned long long)bytes);
+  printf("iterations: %d per thread\n\n", iterations);
+  printf("%8s %12s %10s %12s %14s\n", "threads", "MB/s", "speedup", "efficiency", "allocs/MB");
+
+  for (int threads = 1;; threads = (threads * 2 < max_threads) ? threads * 2 : max_threads) {
+    for (int i = 0; i < threads; i++) {
+      workers[i] = (Worker){ &inputs, expected, iterations, 0, 0 };
+    }
+
+    uint64_t elapsed = run_threads(workers, threads);
+    uint64_t allocations = 0;
+
+    if (elapsed == 0) {
+      fprintf(stderr, "%s: can't create %d threads\n", argv[0], threads);
+      return 1;
+    }
+    for (int i = 0; i < threads; i++) {
+      mismatches += workers[i].mismatches;
+      allocations += workers[i].allocations;
+    }
+
+    double mb = (double)bytes * iterations * threads / 1e6;
+    double mb_per_second = mb / ((double)elapsed / 1e9);
+
+    if (threads == 1) single = mb_per_second;
+    printf("%8d %12.2f %10.2f %12.2f %14.0f\n", threads, mb_per_second,
+           mb_per_second / single, mb_per_second / single / threads,
+           (double)allocations / mb);
+
+    if (threads == max_threads) break;
+  }
+
+  for (size_t i = 0; i < inputs.size; i++) {
+    free(expected[i]);
+  }
+  free(expected);
+  free(workers);
+  bench_inputs_delete(&inputs);
+
+  if (mismatches > 0) {
+    fprintf(stderr, "%zu trees differ\n", mismatches);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,212 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * External scanner trace
+ *
+ * Usage: puppet-trace manifest.pp ...
+ *
+ * Parses every manifest with a parser logger and writes the calls of the
+ * external scanner to a trace file next to it (manifest.trace). The trace
+ * has one line per call:
+ *
+ *   <start> <valid symbols> <token> <end>
+ *
+ * The start and end are byte offsets into the manifest, the valid symbols
+ * are a hex bitmask of the external token types and the token is the type
+ * returned by the scanner or '-' if the parser used the internal lexer. The
+ * traces are replayed by test/scanner/scanner-replay, which checks that the
+ * scanner still returns the same tokens and measures the scanner alone.
+ *
+ * The calls are taken from the parse log: "lex_external" has the external
+ * lex state and the position, and "lexed_lookahead" the token and its size.
+ * If "lex_internal" follows "lex_external", the scanner found no token.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+// The external scanner tables of the language
+#include "../src/tree_sitter/parser.h"
+
+#include "util.h"
+
+
+typedef struct {
+  const TSLanguage *language;
+  uint32_t   *lines;                // byte offset of every line
+  uint32_t   line_count;
+  FILE       *output;
+  bool       pending;               // a scanner call without result
+  uint32_t   start;
+  uint32_t   valid_symbols;
+  uint64_t   calls;
+} Tracer;
+
+
+/**
+ * Return the external token type with the given name that is valid in the
+ * call or -1. Some token types share a name, but only one of them is valid
+ * at a time.
+ */
+
+static int tracer_token(const Tracer *tracer, const char *name, size_t length) {
+  const TSLanguage *language = tracer->language;
+
+  for (uint32_t i = 0; i < language->external_token_count; i++) {
+    const char *symbol = language->symbol_names[language->external_scanner.symbol_map[i]];
+
+    if ((tracer->valid_symbols & (1u << i)) &&
+        strlen(symbol) == length && strncmp(symbol, name, length) == 0) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+static void tracer_log(void *payload, TSLogType log_type, const char *message) {
+  Tracer *tracer = payload;
+  unsigned state, row, column, size;
+  const char *value;
+
+  if (log_type != TSLogTypeParse) return;
+
+  if (sscanf(message, "lex_external state:%u, row:%u, column:%u", &state, &row, &column) == 3) {
+    const TSLanguage *language = tracer->language;
+    const bool *valid = language->external_scanner.states + state * language->external_token_count;
+
+    tracer->pending = (row < tracer->line_count);
+    tracer->start = tracer->pending ? tracer->lines[row] + column : 0;
+    tracer->valid_symbols = 0;
+    for (uint32_t i = 0; i < language->external_token_count; i++) {
+      if (valid[i]) tracer->valid_symbols |= (1u << i);
+    }
+    return;
+  }
+
+  if (!tracer->pending) return;
+
+  if (strncmp(message, "lex_internal ", 13) == 0) {
+    fprintf(tracer->output, "%u %04x - %u\n", tracer->start, tracer->valid_symbols, tracer->start);
+    tracer->calls++;
+    tracer->pending = false;
+    return;
+  }
+
+  if (strncmp(message, "lexed_lookahead sym:", 20) == 0 &&
+      (value = strstr(message, ", size:")) != NULL &&
+      sscanf(value, ", size:%u", &size) == 1) {
+    int token = tracer_token(tracer, message + 20, (size_t)(value - message - 20));
+
+    // An error token ends before the token that the scanner found
+    if (token >= 0) {
+      fprintf(tracer->output, "%u %04x %d %u\n", tracer->start, tracer->valid_symbols,
+              token, tracer->start + size);
+      tracer->calls++;
+    }
+    tracer->pending = false;
+  }
+}
+
+static bool trace_manifest(TSParser *parser, Tracer *tracer, const char *path) {
+  BenchInputs inputs = {0};
+  size_t length = strlen(path);
+
+  if (length < 3 || strcmp(path + length - 3, ".pp") != 0) {
+    fprintf(stderr, "%s: not a manifest\n", path);
+    return false;
+  }
+  if (!bench_inputs_add(&inputs, path)) return false;
+
+  BenchInput *input = &inputs.contents[0];
+  char *trace_path = malloc(length + 4);
+
+  memcpy(trace_path, path, length - 3);
+  strcpy(trace_path + length - 3, ".trace");
+  tracer->output = fopen(trace_path, "w");
+  if (!tracer->output) {
+    fprintf(stderr, "%s: can't write trace\n", trace_path);
+    free(trace_path);
+    bench_inputs_delete(&inputs);
+    return false;
+  }
+
+  tracer->line_count = 1;
+  tracer->lines = malloc((input->length + 1) * sizeof(uint32_t));
+  tracer->lines[0] = 0;
+  for (uint32_t i = 0; i < input->length; i++) {
+    if (input->source[i] == '\n') tracer->lines[tracer->line_count++] = i + 1;
+  }
+  tracer->pending = false;
+  tracer->calls = 0;
+
+  fprintf(tracer->output, "# puppet-trace %s\n", path);
+  fprintf(tracer->output, "# start valid-symbols token end\n");
+
+  TSTree *tree = ts_parser_parse_string(parser, NULL, input->source, input->length);
+  printf("%s: %llu calls%s\n", trace_path, (unsigned long long)tracer->calls,
+         ts_node_has_error(ts_tree_root_node(tree)) ? " (with errors)" : "");
+  ts_tree_delete(tree);
+
+  fclose(tracer->output);
+  free(tracer->lines);
+  free(trace_path);
+  bench_inputs_delete(&inputs);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  Tracer tracer = {0};
+  int failures = 0;
+
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s manifest.pp ...\n", argv[0]);
+    return 2;
+  }
+
+  tracer.language = tree_sitter_puppet();
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tracer.language);
+  ts_parser_set_logger(parser, (TSLogger){ &tracer, tracer_log });
+
+  for (int i = 1; i < argc; i++) {
+    if (!trace_manifest(parser, &tracer, argv[i])) failures++;
+  }
+
+  ts_parser_delete(parser);
+  return failures ? 1 : 0;
+}
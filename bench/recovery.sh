@@ -0,0 +1,67 @@
+#!/bin/sh
+#
+# Regression benchmark for the error recovery of the parser and the
+# external scanner.
+#
+# Usage: bench/recovery.sh [directory]
+#
+# The directory must contain the puppet-bench binary (default: build/bench).
+# Every manifest in bench/broken contains syntax errors. Each manifest is
+# repeated a growing number of times and the copies are parsed by
+# puppet-bench. The recovery time must grow linearly with the number of
+# errors, so the throughput should be about the same for every number of
+# copies. The result is written as CSV to stdout. The script fails if the
+# throughput for the largest number of copies drops below MIN_RATIO times
+# the throughput for the smallest number. The environment variables COPIES,
+# MIN_RATIO and ITERATIONS override the defaults.
+
+set -e
+
+BIN=${1:-build/bench}
+BROKEN=$(dirname "$0")/broken
+COPIES=${COPIES:-"10 100 1000"}
+MIN_RATIO=${MIN_RATIO:-0.5}
+ITERATIONS=${ITERATIONS:-3}
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+field() {
+    sed -n "s/^  \"$1\": \([0-9.]*\),*$/\1/p" "$TMP/result.json"
+}
+
+echo "file,copies,bytes,mb_per_second,p50_us,p99_us"
+
+failed=0
+
+for file in "$BROKEN"/*.pp; do
+    name=$(basename "$file" .pp)
+    first=
+    last=
+
+    for copies in $COPIES; do
+        : > "$TMP/input.pp"
+        i=0
+        while [ "$i" -lt "$copies" ]; do
+            cat "$file" >> "$TMP/input.pp"
+            i=$((i + 1))
+        done
+
+        "$BIN/puppet-bench" -n "$ITERATIONS" -j "$TMP/result.json" "$TMP/input.pp" >/dev/null
+
+        latency=$(sed -n 's/^  "latency_us": {"p50": \([0-9.]*\), "p99": \([0-9.]*\).*/\1,\2/p' "$TMP/result.json")
+        throughput=$(field mb_per_second)
+
+        echo "$name,$copies,$(field bytes),$throughput,$latency"
+
+        first=${first:-$throughput}
+        last=$throughput
+    done
+
+    if awk "BEGIN { exit !($last < $first * $MIN_RATIO) }"; then
+        echo "$name: throughput dropped from $first to $last MB/s" >&2
+        failed=1
+    fi
+done
+
+exit $failed
@@ -0,0 +1,37 @@
+#!/bin/sh
+#
+# Measure how throughput and memory scale with the input size.
+#
+# Usage: bench/scaling.sh [directory]
+#
+# The directory must contain the puppet-gen and puppet-bench binaries
+# (default: build/bench). For every size a manifest is generated and parsed
+# by a separate puppet-bench process, so the peak RSS belongs to that size.
+# The result is written as CSV to stdout. The environment variables SIZES,
+# SEED, MIX, DEPTH and ITERATIONS override the defaults.
+
+set -e
+
+BIN=${1:-build/bench}
+SIZES=${SIZES:-"1K 10K 100K 1M 10M 100M"}
+SEED=${SEED:-1}
+DEPTH=${DEPTH:-3}
+ITERATIONS=${ITERATIONS:-3}
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+field() {
+    sed -n "s/^  \"$1\": \([0-9.]*\),*$/\1/p" "$TMP/result.json"
+}
+
+echo "size,bytes,mb_per_second,nodes_per_second,p50_us,p99_us,peak_rss_kb"
+
+for size in $SIZES; do
+    "$BIN/puppet-gen" -s "$SEED" -d "$DEPTH" -b "$size" ${MIX:+-m "$MIX"} -o "$TMP/input.pp"
+    "$BIN/puppet-bench" -n "$ITERATIONS" -j "$TMP/result.json" "$TMP/input.pp" >/dev/null
+
+    latency=$(sed -n 's/^  "latency_us": {"p50": \([0-9.]*\), "p99": \([0-9.]*\).*/\1,\2/p' "$TMP/result.json")
+
+    echo "$size,$(field bytes),$(field mb_per_second),$(field nodes_per_second),$latency,$(field peak_rss_kb)"
+done
@@ -0,0 +1,35 @@
+#!/bin/sh
+#
+# Compare the streamed parse of large files with a parse of the buffer.
+#
+# Usage: bench/stream.sh [directory]
+#
+# The directory must contain the puppet-gen and puppet-stream binaries
+# (default: build/bench). For every size a manifest is generated and
+# parsed by a separate puppet-stream process per mode, so the peak RSS
+# belongs to that mode. The result is written as CSV to stdout. The
+# environment variables SIZES, MODES, CHUNK_SIZE, SEED and ITERATIONS
+# override the defaults. The largest manifest needs about as much disk
+# space in the temporary directory as its size.
+
+set -e
+
+BIN=${1:-build/bench}
+SIZES=${SIZES:-"1M 10M 100M 1G"}
+MODES=${MODES:-"buffer pread mmap"}
+CHUNK_SIZE=${CHUNK_SIZE:-64K}
+SEED=${SEED:-1}
+ITERATIONS=${ITERATIONS:-3}
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+echo "size,mode,bytes,chunk_size,mb_per_second,nodes,peak_rss_kb"
+
+for size in $SIZES; do
+    "$BIN/puppet-gen" -s "$SEED" -b "$size" -o "$TMP/input.pp"
+
+    for mode in $MODES; do
+        echo "$size,$("$BIN/puppet-stream" -m "$mode" -s "$CHUNK_SIZE" -n "$ITERATIONS" -c "$TMP/input.pp")"
+    done
+done
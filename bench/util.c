@@ -0,0 +1,317 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "util.h"
+
+
+/**
+ * Helper function to check if the filename ends with the given suffix.
+ */
+
+static bool has_suffix(const char *name, const char *suffix) {
+  size_t name_length = strlen(name);
+  size_t suffix_length = strlen(suffix);
+
+  return (name_length >= suffix_length) &&
+    (strcmp(name + name_length - suffix_length, suffix) == 0);
+}
+
+/**
+ * Helper function to check if a line consists of at least three delimiter
+ * characters. The tree-sitter test format allows an optional suffix after
+ * the delimiter, so anything following the delimiter run is ignored.
+ */
+
+static bool is_delimiter(const char *line, const char *end, char delimiter) {
+  const char *p = line;
+
+  while (p < end && *p == delimiter) p++;
+
+  return (p - line) >= 3;
+}
+
+static char *copy_string(const char *start, size_t length) {
+  char *result = malloc(length + 1);
+
+  if (result) {
+    memcpy(result, start, length);
+    result[length] = '\0';
+  }
+  return result;
+}
+
+static void push_input(BenchInputs *inputs, char *name, char *source, size_t length) {
+  if (inputs->size == inputs->capacity) {
+    inputs->capacity = inputs->capacity ? 2 * inputs->capacity : 64;
+    inputs->contents = realloc(inputs->contents,
+                               inputs->capacity * sizeof(BenchInput));
+  }
+  inputs->contents[inputs->size++] = (BenchInput){
+    .name = name,
+    .source = source,
+    .length = (uint32_t)length,
+  };
+}
+
+static char *read_file(const char *path, size_t *length) {
+  FILE *file = fopen(path, "rb");
+  char *buffer = NULL;
+  size_t size = 0, capacity = 0;
+
+  if (!file) return NULL;
+
+  for (;;) {
+    if (capacity - size < 65536) {
+      capacity = capacity ? 2 * capacity : 65536;
+      buffer = realloc(buffer, capacity + 1);
+    }
+    size_t count = fread(buffer + size, 1, capacity - size, file);
+    if (count == 0) break;
+    size += count;
+  }
+  fclose(file);
+
+  buffer[size] = '\0';
+  *length = size;
+  return buffer;
+}
+
+/**
+ * Split a file in the tree-sitter corpus format into its test cases. Only
+ * the source part of each test case is used; the expected tree is skipped.
+ */
+
+static void add_corpus(BenchInputs *inputs, const char *path, const char *text, size_t length) {
+  enum { OUTSIDE, HEADER, SOURCE, EXPECTED } state = OUTSIDE;
+  const char *end = text + length;
+  const char *title = NULL, *title_end = NULL, *source = NULL;
+
+  for (const char *line = text; line < end;) {
+    const char *eol = memchr(line, '\n', end - line);
+    if (!eol) eol = end;
+
+    switch (state) {
+    case OUTSIDE:
+    case EXPECTED:
+      if (is_delimiter(line, eol, '=')) {
+        state = HEADER;
+        title = NULL;
+      }
+      break;
+    case HEADER:
+      if (is_delimiter(line, eol, '=')) {
+        state = SOURCE;
+        source = (eol < end) ? eol + 1 : end;
+      } else if (!title) {
+        title = line;
+        title_end = eol;
+      }
+      break;
+    case SOURCE:
+      if (is_delimiter(line, eol, '-')) {
+        const char *source_end = (line > source) ? line - 1 : source;
+        size_t name_length = strlen(path) + 1 + (title ? title_end - title : 0);
+        char *name = malloc(name_length + 1);
+
+        snprintf(name, name_length + 1, "%s:%.*s", path,
+                 title ? (int)(title_end - title) : 0, title ? title : "");
+        push_input(inputs, name, copy_string(source, source_end - source),
+                   source_end - source);
+        state = EXPECTED;
+      }
+      break;
+    }
+    line = (eol < end) ? eol + 1 : end;
+  }
+}
+
+static int compare_names(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static bool add_directory(BenchInputs *inputs, const char *path) {
+  DIR *dir = opendir(path);
+  char **names = NULL;
+  size_t count = 0, capacity = 0;
+  bool result = true;
+
+  if (!dir) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+
+  for (struct dirent *entry; (entry = readdir(dir)) != NULL;) {
+    if (entry->d_name[0] == '.') continue;
+    if (count == capacity) {
+      capacity = capacity ? 2 * capacity : 32;
+      names = realloc(names, capacity * sizeof(char *));
+    }
+    names[count++] = copy_string(entry->d_name, strlen(entry->d_name));
+  }
+  closedir(dir);
+
+  qsort(names, count, sizeof(char *), compare_names);
+
+  for (size_t i = 0; i < count; i++) {
+    size_t length = strlen(path) + strlen(names[i]) + 2;
+    char *child = malloc(length);
+    struct stat info;
+
+    snprintf(child, length, "%s/%s", path, names[i]);
+    if (stat(child, &info) == 0) {
+      if (S_ISDIR(info.st_mode) ||
+          has_suffix(child, ".pp") || has_suffix(child, ".txt")) {
+        result = bench_inputs_add(inputs, child) && result;
+      }
+    }
+    free(child);
+    free(names[i]);
+  }
+  free(names);
+
+  return result;
+}
+
+bool bench_inputs_add(BenchInputs *inputs, const char *path) {
+  struct stat info;
+  char *text;
+  size_t length;
+
+  if (stat(path, &info) != 0) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+
+  if (S_ISDIR(info.st_mode)) {
+    return add_directory(inputs, path);
+  }
+
+  if (!(text = read_file(path, &length))) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+
+  if (has_suffix(path, ".txt")) {
+    add_corpus(inputs, path, text, length);
+    free(text);
+  } else {
+    push_input(inputs, copy_string(path, strlen(path)), text, length);
+  }
+  return true;
+}
+
+void bench_inputs_delete(BenchInputs *inputs) {
+  for (size_t i = 0; i < inputs->size; i++) {
+    free(inputs->contents[i].name);
+    free(inputs->contents[i].source);
+  }
+  free(inputs->contents);
+  inputs->contents = NULL;
+  inputs->size = inputs->capacity = 0;
+}
+
+uint64_t bench_inputs_bytes(const BenchInputs *inputs) {
+  uint64_t total = 0;
+
+  for (size_t i = 0; i < inputs->size; i++) {
+    total += inputs->contents[i].length;
+  }
+  return total;
+}
+
+uint64_t bench_now_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+
+  return (x > y) - (x < y);
+}
+
+double bench_percentile(double *values, size_t count, double p) {
+  if (count == 0) return 0.0;
+
+  qsort(values, count, sizeof(double), compare_doubles);
+
+  // Nearest-rank method: the rank is ceil(p / 100 * count)
+  double position = p * (double)count / 100.0;
+  size_t rank = (size_t)position;
+  if ((double)rank < position) rank++;
+  if (rank < 1) rank = 1;
+  if (rank > count) rank = count;
+
+  return values[rank - 1];
+}
+
+long bench_peak_rss_kb(void) {
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;  // reported in bytes on macOS
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+void bench_json_string(FILE *file, const char *string) {
+  fputc('"', file);
+  for (const unsigned char *p = (const unsigned char *)string; *p; p++) {
+    switch (*p) {
+    case '"':  fputs("\\\"", file); break;
+    case '\\': fputs("\\\\", file); break;
+    case '\n': fputs("\\n", file); break;
+    case '\r': fputs("\\r", file); break;
+    case '\t': fputs("\\t", file); break;
+    default:
+      if (*p < 0x20) {
+        fprintf(file, "\\u%04x", *p);
+      } else {
+        fputc(*p, file);
+      }
+    }
+  }
+  fputc('"', file);
+}
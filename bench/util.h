@@ -0,0 +1,99 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+#ifndef PUPPET_BENCH_UTIL_H_
+#define PUPPET_BENCH_UTIL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+/**
+ * A single parser input. Corpus files in the tree-sitter test format
+ * contribute one input per test case.
+ */
+
+typedef struct {
+  char     *name;
+  char     *source;
+  uint32_t length;
+} BenchInput;
+
+typedef struct {
+  BenchInput *contents;
+  size_t     size;
+  size_t     capacity;
+} BenchInputs;
+
+
+/**
+ * Add the manifest or corpus file at path to the list of inputs. If path is
+ * a directory, all *.pp and *.txt files below it are added in sorted order.
+ * Return false and print a message on stderr if something can't be read.
+ */
+
+bool bench_inputs_add(BenchInputs *inputs, const char *path);
+
+void bench_inputs_delete(BenchInputs *inputs);
+
+/**
+ * Return the total number of source bytes of all inputs.
+ */
+
+uint64_t bench_inputs_bytes(const BenchInputs *inputs);
+
+/**
+ * Return a monotonic timestamp in nanoseconds.
+ */
+
+uint64_t bench_now_ns(void);
+
+/**
+ * Return the p-th percentile (0 <= p <= 100) of the values. The array is
+ * sorted in place.
+ */
+
+double bench_percentile(double *values, size_t count, double p);
+
+/**
+ * Return the peak resident set size of the process in kilobytes.
+ */
+
+long bench_peak_rss_kb(void);
+
+/**
+ * Write a string as a quoted JSON string.
+ */
+
+void bench_json_string(FILE *file, const char *string);
+
+#endif // PUPPET_BENCH_UTIL_H_
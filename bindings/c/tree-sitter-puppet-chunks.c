@@ -0,0 +1,485 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+// Parallel parsing of a large manifest in chunks, see
+// tree_sitter/tree-sitter-puppet-chunks.h. The pre-scanner that finds the
+// split points skips strings, comments, regular expressions, brackets and
+// the bodies of heredocs the same way as the external scanner.
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/tree-sitter-puppet-chunks.h>
+
+// Limits of the pre-scanner. A manifest that nests deeper or opens more
+// heredocs on a line isn't split after that point.
+#define TREE_SITTER_PUPPET_CHUNKS_MAX_NESTING  64
+#define TREE_SITTER_PUPPET_CHUNKS_MAX_HEREDOCS 64
+
+typedef struct {
+  uint32_t word;                  // offset of the end tag word
+  uint32_t length;                // length of the end tag word in bytes
+} TSPuppetChunkHeredoc;
+
+typedef struct {
+  const char *source;
+  uint32_t   length;
+  uint32_t   position;
+  // The stack of strings and interpolations. Level 0 is the manifest and
+  // every level counts the open brackets.
+  struct {
+    bool     string;              // double quoted string or code
+    uint32_t brackets;
+  } levels[TREE_SITTER_PUPPET_CHUNKS_MAX_NESTING];
+  uint32_t   depth;
+  TSPuppetChunkHeredoc heredocs[TREE_SITTER_PUPPET_CHUNKS_MAX_HEREDOCS];
+  uint32_t   heredoc_count;
+  char       previous;            // the last character of code
+  bool       after_node;          // the last word is the node keyword
+  bool       stuck;               // the limits have been exceeded
+} TSPuppetChunkScanner;
+
+static bool tree_sitter_puppet_chunk_is_word(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+    c == '_' || c == ':';
+}
+
+static bool tree_sitter_puppet_chunk_is_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Return the end of the line that starts at position, before the newline.
+static uint32_t tree_sitter_puppet_chunk_line_end(const TSPuppetChunkScanner *scanner,
+                                                  uint32_t position) {
+  const char *newline = (const char *)memchr(scanner->source + position, '\n',
+                                             scanner->length - position);
+
+  return newline ? (uint32_t)(newline - scanner->source) : scanner->length;
+}
+
+// Skip a heredoc tag "@(word:syntax/escapes)" at the position after "@("
+// and remember the end tag. Return false if this is not a complete tag;
+// the scanner then continues after the "@(".
+static bool tree_sitter_puppet_chunk_heredoc_tag(TSPuppetChunkScanner *scanner) {
+  const char *s = scanner->source;
+  uint32_t end = tree_sitter_puppet_chunk_line_end(scanner, scanner->position);
+  uint32_t p = scanner->position, word, length;
+
+  while (p < end && tree_sitter_puppet_chunk_is_blank(s[p])) p++;
+  word = p;
+  while (p < end && s[p] != ':' && s[p] != '/' && s[p] != ')') p++;
+  length = p - word;
+  while (length > 0 && tree_sitter_puppet_chunk_is_blank(s[word + length - 1])) length--;
+  if (length > 1 && s[word] == '"' && s[word + length - 1] == '"') {
+    word++;
+    length -= 2;
+  }
+  if (length == 0) return false;
+
+  // The syntax and the escapes don't matter here
+  while (p < end && s[p] != ')') p++;
+  if (p == end) return false;
+
+  if (scanner->heredoc_count == TREE_SITTER_PUPPET_CHUNKS_MAX_HEREDOCS) {
+    scanner->stuck = true;
+  } else {
+    scanner->heredocs[scanner->heredoc_count].word = word;
+    scanner->heredocs[scanner->heredoc_count].length = length;
+    scanner->heredoc_count++;
+  }
+  scanner->position = p + 1;
+  scanner->previous = ')';
+  return true;
+}
+
+// Check if the line at position is the end tag of the heredoc:
+// [spaces] ['|'] [spaces] ['-'] [spaces] word [spaces]
+static bool tree_sitter_puppet_chunk_heredoc_end(const TSPuppetChunkScanner *scanner,
+                                                 uint32_t position,
+                                                 const TSPuppetChunkHeredoc *heredoc) {
+  const char *s = scanner->source;
+  uint32_t end = tree_sitter_puppet_chunk_line_end(scanner, position), p = position;
+
+  while (p < end && tree_sitter_puppet_chunk_is_blank(s[p])) p++;
+  if (p < end && s[p] == '|') p++;
+  while (p < end && tree_sitter_puppet_chunk_is_blank(s[p])) p++;
+  if (p < end && s[p] == '-') p++;
+  while (p < end && tree_sitter_puppet_chunk_is_blank(s[p])) p++;
+  if (end - p < heredoc->length || memcmp(s + p, s + heredoc->word, heredoc->length) != 0) {
+    return false;
+  }
+  p += heredoc->length;
+  while (p < end && tree_sitter_puppet_chunk_is_blank(s[p])) p++;
+  return p == end;
+}
+
+// Skip the bodies of the heredocs opened on the line that ends at the
+// current position. Without the end tag the bodies extend to the end of
+// the manifest.
+static void tree_sitter_puppet_chunk_heredoc_bodies(TSPuppetChunkScanner *scanner) {
+  uint32_t line = scanner->position + 1, first = 0;
+
+  while (first < scanner->heredoc_count && line < scanner->length) {
+    if (tree_sitter_puppet_chunk_heredoc_end(scanner, line, &scanner->heredocs[first])) first++;
+    line = tree_sitter_puppet_chunk_line_end(scanner, line) + 1;
+  }
+  if (first < scanner->heredoc_count) line = scanner->length;
+
+  scanner->heredoc_count = 0;
+  // Continue at the newline before the next line, so it can be a split
+  scanner->position = (line > scanner->length) ? scanner->length : line - 1;
+  scanner->previous = ')';
+}
+
+// Check if a top-level statement can start at the position. The line must
+// not continue the statement before, as with "-> Class['x']", "else" or a
+// keyword operator.
+static bool tree_sitter_puppet_chunk_statement_start(const TSPuppetChunkScanner *scanner,
+                                                     uint32_t position) {
+  static const char *continuations[] = { "and", "or", "in", "else", "elsif" };
+  const char *s = scanner->source;
+  uint32_t end = tree_sitter_puppet_chunk_line_end(scanner, position), p = position;
+
+  while (p < end && tree_sitter_puppet_chunk_is_blank(s[p])) p++;
+  if (p == end) return false;
+  if (s[p] == '$' || s[p] == '@') return true;
+  if (!((s[p] >= 'a' && s[p] <= 'z') || (s[p] >= 'A' && s[p] <= 'Z'))) return false;
+
+  uint32_t word = p;
+
+  while (p < end && tree_sitter_puppet_chunk_is_word(s[p])) p++;
+  for (size_t i = 0; i < sizeof(continuations) / sizeof(continuations[0]); i++) {
+    if (strlen(continuations[i]) == p - word &&
+        memcmp(s + word, continuations[i], p - word) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Check if a '/' at the position starts a regular expression and return
+// the position after it or 0. A regex can't span lines, so a wrong guess
+// only affects a single line.
+static uint32_t tree_sitter_puppet_chunk_regex(const TSPuppetChunkScanner *scanner) {
+  const char *s = scanner->source;
+  char c = scanner->previous;
+
+  if (!scanner->after_node &&
+      (tree_sitter_puppet_chunk_is_word(c) || c == ')' || c == ']' || c == '}' || c == '"' ||
+       c == '\'')) {
+    return 0;
+  }
+
+  uint32_t end = tree_sitter_puppet_chunk_line_end(scanner, scanner->position);
+
+  for (uint32_t p = scanner->position + 1; p < end; p++) {
+    if (s[p] == '\\') {
+      p++;
+    } else if (s[p] == '/') {
+      return p + 1;
+    }
+  }
+  return 0;
+}
+
+// Return the position after the next statement boundary where a new chunk
+// can start. The boundary is the start of a line at the top level after a
+// statement that ends with '}' and outside of strings, heredocs, comments
+// and brackets. Return the length of the source if there is none.
+static uint32_t tree_sitter_puppet_chunk_next(TSPuppetChunkScanner *scanner) {
+  const char *s = scanner->source;
+
+  while (!scanner->stuck && scanner->position < scanner->length) {
+    uint32_t p = scanner->position;
+    char c = s[p];
+
+    if (scanner->levels[scanner->depth].string) {
+      if (c == '\\') {
+        scanner->position += 2;
+        continue;
+      } else if (c == '"') {
+        scanner->depth--;
+        scanner->previous = '"';
+      } else if (c == '$' && p + 1 < scanner->length && s[p + 1] == '{') {
+        if (scanner->depth + 1 == TREE_SITTER_PUPPET_CHUNKS_MAX_NESTING) {
+          scanner->stuck = true;
+          break;
+        }
+        scanner->depth++;
+        scanner->levels[scanner->depth].string = false;
+        scanner->levels[scanner->depth].brackets = 0;
+        scanner->position += 2;
+        continue;
+      } else if (c == '\n' && scanner->heredoc_count > 0) {
+        tree_sitter_puppet_chunk_heredoc_bodies(scanner);
+      }
+      scanner->position++;
+      continue;
+    }
+
+    if (tree_sitter_puppet_chunk_is_word(c)) {
+      uint32_t start = p;
+
+      while (p < scanner->length && tree_sitter_puppet_chunk_is_word(s[p])) p++;
+      scanner->after_node = (p - start == 4 && memcmp(s + start, "node", 4) == 0);
+      scanner->previous = s[p - 1];
+      scanner->position = p;
+      continue;
+    }
+
+    switch (c) {
+    case '\n':
+      if (scanner->heredoc_count > 0) {
+        tree_sitter_puppet_chunk_heredoc_bodies(scanner);
+        if (scanner->position >= scanner->length) return scanner->length;
+      }
+      scanner->position++;
+      if (scanner->depth == 0 && scanner->levels[0].brackets == 0 && scanner->previous == '}' &&
+          tree_sitter_puppet_chunk_statement_start(scanner, scanner->position)) {
+        return scanner->position;
+      }
+      continue;
+    case ' ':
+    case '\t':
+    case '\r':
+      scanner->position++;
+      continue;
+    case '#':
+      scanner->position = tree_sitter_puppet_chunk_line_end(scanner, p);
+      continue;
+    case '/':
+      if (p + 1 < scanner->length && s[p + 1] == '*') {
+        const char *end = NULL;
+
+        for (uint32_t q = p + 2; q + 1 < scanner->length; q++) {
+          if (s[q] == '*' && s[q + 1] == '/') {
+            end = s + q + 2;
+            break;
+          }
+        }
+        scanner->position = end ? (uint32_t)(end - s) : scanner->length;
+        continue;
+      } else {
+        uint32_t end = tree_sitter_puppet_chunk_regex(scanner);
+
+        if (end > 0) {
+          scanner->position = end;
+          scanner->previous = '/';
+          scanner->after_node = false;
+          continue;
+        }
+      }
+      break;
+    case '\'':
+      for (p++; p < scanner->length && s[p] != '\''; p++) {
+        if (s[p] == '\\') p++;
+      }
+      scanner->position = p + 1;
+      scanner->previous = '\'';
+      scanner->after_node = false;
+      continue;
+    case '"':
+      if (scanner->depth + 1 == TREE_SITTER_PUPPET_CHUNKS_MAX_NESTING) {
+        scanner->stuck = true;
+        continue;
+      }
+      scanner->depth++;
+      scanner->levels[scanner->depth].string = true;
+      scanner->position++;
+      continue;
+    case '@':
+      if (p + 1 < scanner->length && s[p + 1] == '(') {
+        scanner->position += 2;
+        scanner->after_node = false;
+        if (tree_sitter_puppet_chunk_heredoc_tag(scanner)) continue;
+        scanner->previous = '(';
+        scanner->levels[scanner->depth].brackets++;
+        continue;
+      }
+      break;
+    case '(':
+    case '[':
+    case '{':
+      scanner->levels[scanner->depth].brackets++;
+      break;
+    case ')':
+    case ']':
+    case '}':
+      if (scanner->levels[scanner->depth].brackets > 0) {
+        scanner->levels[scanner->depth].brackets--;
+      } else if (c == '}' && scanner->depth > 0) {
+        // The end of an interpolation
+        scanner->depth--;
+        scanner->position++;
+        continue;
+      }
+      break;
+    default:
+      break;
+    }
+
+    scanner->previous = c;
+    scanner->after_node = false;
+    scanner->position++;
+  }
+
+  return scanner->length;
+}
+
+size_t tree_sitter_puppet_chunks_find(const char *source, uint32_t length,
+                                      uint32_t chunk_size, TSRange **ranges) {
+  TSPuppetChunkScanner *scanner = (TSPuppetChunkScanner *)calloc(1, sizeof(TSPuppetChunkScanner));
+  size_t count = 0, capacity = 16;
+  uint32_t start = 0, row = 0, line_start = 0;
+
+  *ranges = (TSRange *)malloc(capacity * sizeof(TSRange));
+  if (!scanner || !*ranges) {
+    free(scanner);
+    free(*ranges);
+    *ranges = NULL;
+    return 0;
+  }
+  scanner->source = source;
+  scanner->length = length;
+
+  do {
+    uint32_t end;
+
+    // Find the first boundary at least chunk_size bytes after the start
+    do {
+      end = tree_sitter_puppet_chunk_next(scanner);
+    } while (end < length && end - start < chunk_size);
+
+    if (count == capacity) {
+      TSRange *larger = (TSRange *)realloc(*ranges, 2 * capacity * sizeof(TSRange));
+
+      if (!larger) {
+        free(scanner);
+        free(*ranges);
+        *ranges = NULL;
+        return 0;
+      }
+      *ranges = larger;
+      capacity *= 2;
+    }
+
+    TSRange *range = &(*ranges)[count++];
+
+    range->start_byte = start;
+    range->start_point.row = row;
+    range->start_point.column = start - line_start;
+    for (const char *p = source + start;
+         (p = (const char *)memchr(p, '\n', (size_t)(source + end - p))) != NULL; p++) {
+      row++;
+      line_start = (uint32_t)(p - source) + 1;
+    }
+    range->end_byte = end;
+    range->end_point.row = row;
+    range->end_point.column = end - line_start;
+    start = end;
+  } while (start < length);
+
+  free(scanner);
+  return count;
+}
+
+typedef struct {
+  const char     *source;
+  uint32_t       length;
+  const TSRange  *ranges;
+  size_t         count;
+  TSTree         **trees;
+  size_t         next;
+  pthread_mutex_t lock;
+} TSPuppetChunkQueue;
+
+static void *tree_sitter_puppet_chunk_worker(void *payload) {
+  TSPuppetChunkQueue *queue = (TSPuppetChunkQueue *)payload;
+  TSParser *parser = ts_parser_new();
+
+  ts_parser_set_language(parser, tree_sitter_puppet());
+
+  for (;;) {
+    pthread_mutex_lock(&queue->lock);
+    size_t next = queue->next++;
+    pthread_mutex_unlock(&queue->lock);
+
+    if (next >= queue->count) break;
+    ts_parser_set_included_ranges(parser, &queue->ranges[next], 1);
+    queue->trees[next] = ts_parser_parse_string(parser, NULL, queue->source, queue->length);
+  }
+
+  ts_parser_delete(parser);
+  return NULL;
+}
+
+bool tree_sitter_puppet_chunks_parse(const char *source, uint32_t length,
+                                     const TSRange *ranges, size_t count,
+                                     unsigned threads, TSTree **trees) {
+  TSPuppetChunkQueue queue;
+  pthread_t *ids;
+  unsigned started = 0;
+  bool ok = true;
+
+  queue.source = source;
+  queue.length = length;
+  queue.ranges = ranges;
+  queue.count = count;
+  queue.trees = trees;
+  queue.next = 0;
+  pthread_mutex_init(&queue.lock, NULL);
+  memset(trees, 0, count * sizeof(TSTree *));
+
+  if (threads > count) threads = (unsigned)count;
+  ids = (pthread_t *)calloc(threads ? threads : 1, sizeof(pthread_t));
+  while (ids && started < threads &&
+         pthread_create(&ids[started], NULL, tree_sitter_puppet_chunk_worker, &queue) == 0) {
+    started++;
+  }
+  // Parse on the calling thread if no thread could be started
+  if (started == 0) tree_sitter_puppet_chunk_worker(&queue);
+  for (unsigned i = 0; i < started; i++) {
+    pthread_join(ids[i], NULL);
+  }
+  free(ids);
+  pthread_mutex_destroy(&queue.lock);
+
+  for (size_t i = 0; i < count; i++) {
+    if (!trees[i]) ok = false;
+  }
+  if (!ok) {
+    for (size_t i = 0; i < count; i++) {
+      if (trees[i]) ts_tree_delete(trees[i]);
+      trees[i] = NULL;
+    }
+  }
+  return ok;
+}
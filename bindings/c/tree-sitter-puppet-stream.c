@@ -0,0 +1,209 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+// Parsing of a manifest file in bounded memory, see
+// tree_sitter/tree-sitter-puppet-stream.h.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <tree_sitter/tree-sitter-puppet-stream.h>
+
+// The smallest window, which holds the longest UTF-8 character
+#define STREAM_MIN_WINDOW 4
+
+// Read the window that starts at the given offset. A mapping must start at
+// a multiple of the page size, so it starts before the offset then.
+static bool tree_sitter_puppet_stream_fill(TSPuppetStream *stream, uint32_t offset) {
+  uint32_t length = stream->length - offset;
+
+  if (length > stream->chunk_size) length = stream->chunk_size;
+
+  if (stream->mode == TSPuppetStreamMap) {
+    long page = sysconf(_SC_PAGESIZE);
+
+    if (page <= 0) {
+      stream->error = EINVAL;
+      return false;
+    }
+
+    uint32_t start = offset - offset % (uint32_t)page;
+
+    if (stream->mapping) munmap(stream->mapping, stream->mapping_size);
+    stream->mapping_size = (size_t)(offset - start) + length;
+    stream->mapping = mmap(NULL, stream->mapping_size, PROT_READ, MAP_PRIVATE, stream->fd,
+                           (off_t)start);
+    if (stream->mapping == MAP_FAILED) {
+      stream->mapping = NULL;
+      stream->error = errno;
+      return false;
+    }
+    stream->window = (const char *)stream->mapping + (offset - start);
+  } else {
+    uint32_t done = 0;
+
+    while (done < length) {
+      ssize_t count = pread(stream->fd, stream->buffer + done, length - done,
+                            (off_t)offset + done);
+
+      if (count < 0 && errno == EINTR) continue;
+      if (count <= 0) {
+        // The file has been truncated while it is parsed
+        stream->error = (count < 0) ? errno : EIO;
+        return false;
+      }
+      done += (uint32_t)count;
+    }
+    stream->window = stream->buffer;
+  }
+
+  stream->window_start = offset;
+  stream->window_length = length;
+  return true;
+}
+
+// The read callback of the TSInput. The returned text stays valid until the
+// next call, as tree-sitter requires. A read error ends the input; it is
+// kept in the error field of the stream.
+static const char *tree_sitter_puppet_stream_read(void *payload, uint32_t byte_index,
+                                                  TSPoint position, uint32_t *bytes_read) {
+  TSPuppetStream *stream = (TSPuppetStream *)payload;
+
+  (void)position;
+
+  if (byte_index >= stream->length || stream->error != 0) {
+    *bytes_read = 0;
+    return "";
+  }
+
+  uint32_t window_end = stream->window_start + stream->window_length;
+
+  // tree-sitter reads again inside the window when it goes back for a
+  // lookahead and after a character that crosses the end of a chunk. A
+  // UTF-8 character has up to 4 bytes, so a window that ends less than 4
+  // bytes after the index may cut the character in two. The runtime only
+  // reads again once and then takes the partial character as an invalid
+  // one, so the next window must start at the index.
+  if (!stream->window || byte_index < stream->window_start || byte_index >= window_end ||
+      (window_end - byte_index < STREAM_MIN_WINDOW && window_end < stream->length)) {
+    if (!tree_sitter_puppet_stream_fill(stream, byte_index)) {
+      *bytes_read = 0;
+      return "";
+    }
+  }
+
+  *bytes_read = stream->window_start + stream->window_length - byte_index;
+  return stream->window + (byte_index - stream->window_start);
+}
+
+bool tree_sitter_puppet_stream_init(TSPuppetStream *stream, int fd,
+                                    uint32_t chunk_size, TSPuppetStreamMode mode) {
+  struct stat status;
+
+  memset(stream, 0, sizeof(TSPuppetStream));
+  stream->fd = fd;
+  stream->mode = mode;
+  stream->chunk_size = chunk_size ? chunk_size : TREE_SITTER_PUPPET_STREAM_CHUNK_SIZE;
+  if (stream->chunk_size < STREAM_MIN_WINDOW) stream->chunk_size = STREAM_MIN_WINDOW;
+
+  if (fstat(fd, &status) != 0) return false;
+  if ((uint64_t)status.st_size >= UINT32_MAX) {
+    errno = EFBIG;
+    return false;
+  }
+  stream->length = (uint32_t)status.st_size;
+
+  if (mode == TSPuppetStreamRead) {
+    stream->buffer = (char *)malloc(stream->chunk_size);
+    if (!stream->buffer) {
+      errno = ENOMEM;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool tree_sitter_puppet_stream_open(TSPuppetStream *stream, const char *path,
+                                    uint32_t chunk_size, TSPuppetStreamMode mode) {
+  int fd = open(path, O_RDONLY);
+
+  if (fd < 0) return false;
+  if (!tree_sitter_puppet_stream_init(stream, fd, chunk_size, mode)) {
+    int error = errno;
+
+    free(stream->buffer);
+    stream->buffer = NULL;
+    close(fd);
+    errno = error;
+    return false;
+  }
+  stream->owns_fd = true;
+  return true;
+}
+
+TSInput tree_sitter_puppet_stream_input(TSPuppetStream *stream) {
+  TSInput input;
+
+  memset(&input, 0, sizeof(TSInput));
+  input.payload = stream;
+  input.read = tree_sitter_puppet_stream_read;
+  input.encoding = TSInputEncodingUTF8;
+  return input;
+}
+
+TSTree *tree_sitter_puppet_stream_parse(TSParser *parser, const TSTree *old_tree,
+                                        TSPuppetStream *stream) {
+  TSTree *tree;
+
+  // Every parse starts with a new window
+  stream->error = 0;
+  stream->window = NULL;
+  tree = ts_parser_parse(parser, old_tree, tree_sitter_puppet_stream_input(stream));
+  if (tree && stream->error != 0) {
+    ts_tree_delete(tree);
+    tree = NULL;
+  }
+  return tree;
+}
+
+void tree_sitter_puppet_stream_close(TSPuppetStream *stream) {
+  if (stream->mapping) munmap(stream->mapping, stream->mapping_size);
+  free(stream->buffer);
+  if (stream->owns_fd) close(stream->fd);
+  memset(stream, 0, sizeof(TSPuppetStream));
+  stream->fd = -1;
+}
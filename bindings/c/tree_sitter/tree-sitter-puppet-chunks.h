@@ -0,0 +1,48 @@
+#ifndef TREE_SITTER_PUPPET_CHUNKS_H_
+#define TREE_SITTER_PUPPET_CHUNKS_H_
+
+// Parallel parsing of a large manifest in chunks.
+//
+// tree_sitter_puppet_chunks_find splits a manifest into chunks at the
+// boundaries between top-level statements and tree_sitter_puppet_chunks_parse
+// parses the chunks on several threads. Every chunk becomes a tree of its
+// own. The trees are parsed with the chunk as the included range of the
+// complete source, so all nodes have their byte offsets and points in the
+// complete manifest. The top-level nodes of the trees in order are the
+// top-level nodes of a parse of the complete manifest.
+//
+// The functions are part of the tree-sitter-puppet-helpers library, which
+// needs the tree-sitter runtime library and POSIX threads.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Split the manifest into chunks of at least chunk_size bytes that can be
+// parsed independently. The chunks are returned as a newly allocated array
+// of ranges that cover the complete source in order; free it with free().
+// Return the number of chunks, which is 1 if the manifest can't be split,
+// or 0 with *ranges set to NULL if the memory can't be allocated.
+size_t tree_sitter_puppet_chunks_find(const char *source, uint32_t length,
+                                      uint32_t chunk_size, TSRange **ranges);
+
+// Parse the chunks found by tree_sitter_puppet_chunks_find on the given
+// number of threads with one parser per thread and store the tree of each
+// chunk in trees, which must have room for count trees. Return false if a
+// chunk couldn't be parsed; all trees are deleted then.
+bool tree_sitter_puppet_chunks_parse(const char *source, uint32_t length,
+                                     const TSRange *ranges, size_t count,
+                                     unsigned threads, TSTree **trees);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_PUPPET_CHUNKS_H_
@@ -0,0 +1,82 @@
+#ifndef TREE_SITTER_PUPPET_STREAM_H_
+#define TREE_SITTER_PUPPET_STREAM_H_
+
+// Parsing of a manifest file in bounded memory.
+//
+// A TSPuppetStream reads a file in windows of a fixed size and provides
+// them to tree-sitter through the read callback of a TSInput, so the
+// complete source is never in memory. The windows are read with pread(2)
+// into a buffer of the chunk size or mapped with mmap(2); a mapping is
+// removed when the next window is mapped. tree-sitter doesn't keep the
+// source, so the memory of a parse is the tree and a single window.
+//
+// The functions are part of the tree-sitter-puppet-helpers library, which
+// needs the tree-sitter runtime library and POSIX file functions.
+// tree-sitter uses 32-bit byte offsets, so a file must be smaller than
+// 4 GB.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The default size of a window
+#define TREE_SITTER_PUPPET_STREAM_CHUNK_SIZE (64 * 1024)
+
+typedef enum {
+  TSPuppetStreamRead,             // pread(2) into a buffer
+  TSPuppetStreamMap,              // mmap(2) of a window of the file
+} TSPuppetStreamMode;
+
+typedef struct {
+  int        fd;
+  bool       owns_fd;             // the file is closed by the stream
+  TSPuppetStreamMode mode;
+  uint32_t   length;              // the size of the file
+  uint32_t   chunk_size;
+  char       *buffer;             // the window for TSPuppetStreamRead
+  void       *mapping;            // the window for TSPuppetStreamMap
+  size_t     mapping_size;
+  uint32_t   window_start;        // the offset of the window in the file
+  uint32_t   window_length;
+  const char *window;             // the start of the window in memory
+  int        error;               // errno of the first failed read or 0
+} TSPuppetStream;
+
+// Prepare a stream for the open file descriptor, which isn't closed by the
+// stream. A chunk_size of 0 uses TREE_SITTER_PUPPET_STREAM_CHUNK_SIZE; a
+// window has at least 4 bytes, so it can hold every UTF-8 character.
+// Return false and set errno if the file can't be used.
+bool tree_sitter_puppet_stream_init(TSPuppetStream *stream, int fd,
+                                    uint32_t chunk_size, TSPuppetStreamMode mode);
+
+// Open the file at path for a stream. Return false and set errno if the
+// file can't be opened.
+bool tree_sitter_puppet_stream_open(TSPuppetStream *stream, const char *path,
+                                    uint32_t chunk_size, TSPuppetStreamMode mode);
+
+// Return the TSInput that reads from the stream. The returned text stays
+// valid until the next read, as tree-sitter requires. A read error ends
+// the input; it is kept in the error field of the stream.
+TSInput tree_sitter_puppet_stream_input(TSPuppetStream *stream);
+
+// Parse the file of the stream with the parser, which must use the Puppet
+// language. Return NULL if the parse fails or the file can't be read; the
+// error field of the stream has the errno of a read error then.
+TSTree *tree_sitter_puppet_stream_parse(TSParser *parser, const TSTree *old_tree,
+                                        TSPuppetStream *stream);
+
+// Release the window and close the file if the stream has opened it.
+void tree_sitter_puppet_stream_close(TSPuppetStream *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_PUPPET_STREAM_H_
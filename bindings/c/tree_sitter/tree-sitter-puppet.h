@@ -7,8 +7,38 @@ typedef struct TSLanguage TSLanguage;
 extern "C" {
 #endif
 
+// Return the Puppet language. The language is immutable and can be shared
+// by any number of parsers on any number of threads. Every parser creates
+// its own instance of the external scanner, which keeps its state only in
+// that instance, so parsers on different threads don't interfere. As usual
+// for tree-sitter, a single parser must not be used by two threads at the
+// same time and a tree is shared between threads with ts_tree_copy.
 const TSLanguage *tree_sitter_puppet(void);
 
+#ifdef TREE_SITTER_PUPPET_STATS
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Statistics of the external scanner. Only available if the library has
+// been built with TREE_SITTER_PUPPET_STATS defined. The counters are global
+// to the process and not synchronized, so a build with statistics is not
+// thread-safe. Only parse on a single thread while the counters are used.
+
+// Reset all counters to zero.
+void tree_sitter_puppet_scanner_stats_reset(void);
+
+// Write the counters as a JSON object into the buffer. Like snprintf the
+// return value is the length of the complete output, which may be larger
+// than the buffer size.
+size_t tree_sitter_puppet_scanner_stats_json(char *buffer, size_t size);
+
+// Return the number of characters the scanner advanced over since the last
+// reset, including the look-ahead that is not part of a token.
+uint64_t tree_sitter_puppet_scanner_stats_chars(void);
+
+#endif // TREE_SITTER_PUPPET_STATS
+
 #ifdef __cplusplus
 }
 #endif
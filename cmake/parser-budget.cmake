@@ -0,0 +1,59 @@
+# Check the size of the generated parser against a budget.
+#
+# Usage: cmake -DPARSER=src/parser.c -P cmake/parser-budget.cmake
+#
+# The script fails if the number of states or symbols or the size of the
+# parse tables in the generated parser exceeds the values below. Lower the
+# budget when a grammar change makes the tables smaller, so a later change
+# can't silently grow them again.
+
+set(BUDGET_STATE_COUNT 1673)
+set(BUDGET_LARGE_STATE_COUNT 582)
+set(BUDGET_SYMBOL_COUNT 208)
+
+# Bytes of the dense table: LARGE_STATE_COUNT * SYMBOL_COUNT entries
+set(BUDGET_PARSE_TABLE_BYTES 242112)
+
+# Entries of the compressed table, taken from the offset of the last state
+# in ts_small_parse_table_map
+set(BUDGET_SMALL_PARSE_TABLE_SIZE 41302)
+
+if(NOT PARSER)
+  message(FATAL_ERROR "PARSER must be set to the generated parser.c")
+endif()
+
+file(STRINGS "${PARSER}" DEFINES
+     REGEX "^#define (STATE_COUNT|LARGE_STATE_COUNT|SYMBOL_COUNT) [0-9]+$")
+foreach(DEFINE IN LISTS DEFINES)
+  string(REGEX MATCH "^#define ([A-Z_]+) ([0-9]+)$" _ "${DEFINE}")
+  set(${CMAKE_MATCH_1} ${CMAKE_MATCH_2})
+endforeach()
+
+file(STRINGS "${PARSER}" SMALL_STATES REGEX "^  \\[SMALL_STATE\\([0-9]+\\)\\] = [0-9]+,$")
+list(LENGTH SMALL_STATES SMALL_STATE_COUNT)
+set(SMALL_PARSE_TABLE_SIZE 0)
+if(SMALL_STATE_COUNT GREATER 0)
+  list(GET SMALL_STATES -1 LAST_SMALL_STATE)
+  string(REGEX MATCH "= ([0-9]+)," _ "${LAST_SMALL_STATE}")
+  set(SMALL_PARSE_TABLE_SIZE ${CMAKE_MATCH_1})
+endif()
+
+if(NOT DEFINED STATE_COUNT OR NOT DEFINED LARGE_STATE_COUNT OR NOT DEFINED SYMBOL_COUNT)
+  message(FATAL_ERROR "${PARSER}: table sizes not found")
+endif()
+math(EXPR PARSE_TABLE_BYTES "${LARGE_STATE_COUNT} * ${SYMBOL_COUNT} * 2")
+
+set(FAILED FALSE)
+foreach(VALUE STATE_COUNT LARGE_STATE_COUNT SYMBOL_COUNT
+              PARSE_TABLE_BYTES SMALL_PARSE_TABLE_SIZE)
+  if(${VALUE} GREATER ${BUDGET_${VALUE}})
+    message(SEND_ERROR "${VALUE} ${${VALUE}} exceeds the budget of ${BUDGET_${VALUE}}")
+    set(FAILED TRUE)
+  elseif(${VALUE} LESS ${BUDGET_${VALUE}})
+    message(STATUS "${VALUE} ${${VALUE}} is below the budget of ${BUDGET_${VALUE}}")
+  endif()
+endforeach()
+
+if(FAILED)
+  message(FATAL_ERROR "The parser exceeds its budget, see cmake/parser-budget.cmake")
+endif()
@@ -30,11 +30,10 @@
 
 
 #include <stdlib.h>
-#include <ctype.h>
+#include <string.h>
 
 #include "tree_sitter/parser.h"
 #include "tree_sitter/alloc.h"
-#include "tree_sitter/array.h"
 
 
 /**
@@ -58,50 +57,407 @@ enum TokenType {
   HEREDOC_ESCAPE_SEQUENCE,
   DQ_ESCAPE_SEQUENCE,
   SQ_ESCAPE_SEQUENCE,
+  TOKEN_TYPE_COUNT,
 };
 
 /**
- * heredoc escape flags
+ * The escapes enabled for a heredoc are kept as a bitmask. Every escape
+ * flag has its own bit and the backslash, which is enabled together with
+ * any other escape, uses the highest bit. HEREDOC_ESCAPE_FLAGS maps the
+ * ASCII characters to their bit.
  */
 
-const int32_t HEREDOC_ESCAPES[] = {
-  U'n',  U'r',  U't',  U's',  U'$', U'u', U'L',
+#define HEREDOC_ESCAPES_ALL       0x7f
+#define HEREDOC_ESCAPE_BACKSLASH  0x80
+
+static const uint8_t HEREDOC_ESCAPE_FLAGS[128] = {
+  [U'n'] = 0x01,
+  [U'r'] = 0x02,
+  [U't'] = 0x04,
+  [U's'] = 0x08,
+  [U'$'] = 0x10,
+  [U'u'] = 0x20,
+  [U'L'] = 0x40,
 };
 
 /**
- * Manage UTF32 strings using an array.
+ * Character classes of the ASCII characters. The lookahead of the lexer is
+ * a Unicode code point, so the scanner uses this table instead of the
+ * locale dependent functions from ctype.h, which are undefined for most
+ * code points. Characters outside of ASCII have no class.
  */
 
-typedef Array(int32_t) UTF32String;
+#define CHAR_SPACE         0x01  // isspace()
+#define CHAR_DIGIT         0x02  // isdigit()
+#define CHAR_XDIGIT        0x04  // isxdigit()
+#define CHAR_ALPHA         0x08  // isalpha()
+#define CHAR_VARIABLE      0x10  // 'a'..'z', '0'..'9', '_', ':'
+#define CHAR_HEREDOC_STOP  0x20  // ends the word of a heredoc tag
+
+#define S  (CHAR_SPACE)
+#define N  (CHAR_SPACE | CHAR_HEREDOC_STOP)
+#define D  (CHAR_DIGIT | CHAR_XDIGIT | CHAR_VARIABLE)
+#define A  (CHAR_ALPHA)
+#define X  (CHAR_ALPHA | CHAR_XDIGIT)
+#define V  (CHAR_ALPHA | CHAR_VARIABLE)
+#define XV (CHAR_ALPHA | CHAR_XDIGIT | CHAR_VARIABLE)
+#define U_ (CHAR_VARIABLE)
+#define C_ (CHAR_VARIABLE | CHAR_HEREDOC_STOP)
+#define H  (CHAR_HEREDOC_STOP)
+
+static const uint8_t CHAR_CLASSES[128] = {
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  S,  N,  S,  S,  N,  0,  0,  // 0x00
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  // 0x10
+  S,  0,  0,  0,  0,  0,  0,  0,  0,  H,  0,  0,  0,  0,  0,  H,  //  !"#$%&'()*+,-./
+  D,  D,  D,  D,  D,  D,  D,  D,  D,  D,  C_, 0,  0,  0,  0,  0,  // 0123456789:;<=>?
+  0,  X,  X,  X,  X,  X,  X,  A,  A,  A,  A,  A,  A,  A,  A,  A,  // @ABCDEFGHIJKLMNO
+  A,  A,  A,  A,  A,  A,  A,  A,  A,  A,  A,  0,  0,  0,  0,  U_, // PQRSTUVWXYZ[\]^_
+  0,  XV, XV, XV, XV, XV, XV, V,  V,  V,  V,  V,  V,  V,  V,  V,  // `abcdefghijklmno
+  V,  V,  V,  V,  V,  V,  V,  V,  V,  V,  V,  0,  0,  0,  0,  0,  // pqrstuvwxyz{|}~
+};
+
+#undef S
+#undef N
+#undef D
+#undef A
+#undef X
+#undef V
+#undef XV
+#undef U_
+#undef C_
+#undef H
+
+/**
+ * Limits for the inline storage of the scanner state. The characters of all
+ * open heredocs share a single buffer that has room for one character per
+ * byte of the serialization buffer. That is more than the serialized state
+ * can hold, so the buffer is never the limiting factor.
+ */
+
+#define MAX_OPEN_HEREDOCS  64
+#define HEREDOC_CHARS_SIZE TREE_SITTER_SERIALIZATION_BUFFER_SIZE
+
+/**
+ * The number of characters that the scanner reads ahead at the start of a
+ * heredoc body to find the end tag and its indent. If the end tag is
+ * further away, the heredoc is accepted without an indent and the indent
+ * becomes part of the content. This keeps the look-ahead of large heredocs
+ * and of unterminated heredoc tags bounded.
+ */
+
+#define HEREDOC_INDENT_SCAN_LIMIT (64 * 1024)
+
+/**
+ * The maximum length of a heredoc end tag word. The word is read up to the
+ * closing parenthesis, so without a limit every "@(" on a long line would
+ * read the rest of the line.
+ */
+
+#define MAX_HEREDOC_WORD_LENGTH 256
+
+/**
+ * An open heredoc. The characters of the heredoc are stored in the
+ * character buffer of the scanner state starting at offset: first the end
+ * tag word and then the indent of the end tag. The heredocs are stored in
+ * the order they have been opened and their characters follow each other
+ * without gaps.
+ */
 
 typedef struct {
-  UTF32String word;
-  UTF32String indent;
-  UTF32String escapes;
-  bool        allows_interpolation;
-  bool        started;
-  bool        end_valid;
+  uint16_t offset;
+  uint16_t word_length;
+  uint16_t indent_length;
+  uint8_t  escapes;
+  bool     allows_interpolation;
+  bool     started;
+  bool     end_valid;
 } Heredoc;
 
 /**
  * The state of the scanner to keep track of the heredoc tag that we are
- * currently looking for.
+ * currently looking for. The state uses no dynamic memory, so it can be
+ * restored without allocations.
  */
 
 typedef struct ScannerState {
-  bool           inside_interpolation_variable;
-  bool           check_selbrace;
-  Array(Heredoc) open_heredocs;
+  bool     inside_interpolation_variable;
+  bool     check_selbrace;
+  uint16_t heredoc_count;
+  uint16_t chars_used;
+  Heredoc  heredocs[MAX_OPEN_HEREDOCS];
+  int32_t  chars[HEREDOC_CHARS_SIZE];
 } ScannerState;
 
 
+/**
+ * Scanner statistics. If TREE_SITTER_PUPPET_STATS is defined the scanner
+ * counts the calls per combination of valid symbols, the returned tokens,
+ * the characters consumed by the scan_* functions, the serialization
+ * traffic and the allocations of scanner states. The counters are global
+ * to the process and not synchronized, so they are only meaningful if a
+ * single thread is parsing. Without the macro all of this compiles to
+ * nothing.
+ */
+
+#ifdef TREE_SITTER_PUPPET_STATS
+
+#include <stdarg.h>
+#include <stdio.h>
+
+/**
+ * The scan_* functions that are measured. The characters consumed by
+ * scan_newline, scan_heredoc_end_tag and scan_interpolation_start count
+ * for the function calling them. SCAN_INDENT is the heredoc indentation
+ * that is skipped before the body of the heredoc is scanned.
+ */
+
+enum ScanHelper {
+  SCAN_INDENT,
+  SCAN_SELBRACE,
+  SCAN_INTERPOLATION,
+  SCAN_SQ_ESCAPE_SEQUENCE,
+  SCAN_DQ_ESCAPE_SEQUENCE,
+  SCAN_HEREDOC_ESCAPE_SEQUENCE,
+  SCAN_SQ_STRING,
+  SCAN_INTERPOLATION_NOSIGIL_VARIABLE,
+  SCAN_DQ_STRING,
+  SCAN_HEREDOC_START,
+  SCAN_HEREDOC_END_TAG_INDENT,
+  SCAN_HEREDOC_CONTENT,
+  SCAN_HEREDOC_BODY_START,
+  SCAN_HELPER_COUNT,
+};
+
+static const char *SCAN_HELPER_NAMES[SCAN_HELPER_COUNT] = {
+  "indent",
+  "scan_selbrace",
+  "scan_interpolation",
+  "scan_sq_escape_sequence",
+  "scan_dq_escape_sequence",
+  "scan_heredoc_escape_sequence",
+  "scan_sq_string",
+  "scan_interpolation_nosigil_variable",
+  "scan_dq_string",
+  "scan_heredoc_start",
+  "scan_heredoc_end_tag_indent",
+  "scan_heredoc_content",
+  "scan_heredoc_body_start",
+};
+
+static const char *TOKEN_TYPE_NAMES[TOKEN_TYPE_COUNT] = {
+  "qmark",
+  "selbrace",
+  "sq_string",
+  "dq_string",
+  "interpolation_nobrace_variable",
+  "interpolation_brace_variable",
+  "interpolation_expression",
+  "interpolation_nosigil_variable",
+  "heredoc_start",
+  "heredoc_body_start",
+  "heredoc_content",
+  "heredoc_body_end",
+  "heredoc_escape_sequence",
+  "dq_escape_sequence",
+  "sq_escape_sequence",
+};
+
+// The parser only uses a few different combinations of valid symbols, so
+// a small table is sufficient. Combinations that don't fit are counted as
+// overflow.
+#define STATS_VALID_SYMBOLS_SIZE 64
+
+static struct {
+  uint64_t scan_calls;
+  uint64_t scan_failures;
+  uint64_t scan_returns[TOKEN_TYPE_COUNT];
+  struct {
+    uint32_t mask;
+    uint64_t calls;
+  } valid_symbols[STATS_VALID_SYMBOLS_SIZE];
+  uint32_t valid_symbols_used;
+  uint64_t valid_symbols_overflow;
+  uint64_t helper_calls[SCAN_HELPER_COUNT];
+  uint64_t helper_chars[SCAN_HELPER_COUNT];
+  uint64_t serialize_calls;
+  uint64_t serialize_bytes;
+  uint64_t deserialize_calls;
+  uint64_t deserialize_bytes;
+  uint64_t alloc_calls;
+  uint64_t alloc_bytes;
+  uint64_t free_calls;
+  enum ScanHelper current;
+} stats;
+
+static void stats_count_valid_symbols(const bool *valid_symbols) {
+  uint32_t mask = 0;
+
+  for (unsigned i = 0; i < TOKEN_TYPE_COUNT; i++) {
+    if (valid_symbols[i]) mask |= (1u << i);
+  }
+
+  stats.scan_calls++;
+  for (uint32_t i = 0; i < stats.valid_symbols_used; i++) {
+    if (stats.valid_symbols[i].mask == mask) {
+      stats.valid_symbols[i].calls++;
+      return;
+    }
+  }
+  if (stats.valid_symbols_used < STATS_VALID_SYMBOLS_SIZE) {
+    stats.valid_symbols[stats.valid_symbols_used].mask = mask;
+    stats.valid_symbols[stats.valid_symbols_used].calls = 1;
+    stats.valid_symbols_used++;
+  } else {
+    stats.valid_symbols_overflow++;
+  }
+}
+
+#define STATS_HELPER(helper) (stats.current = (helper), stats.helper_calls[helper]++)
+#define STATS_ADVANCE()      (stats.helper_chars[stats.current]++)
+#define STATS_ADD(counter, value) (stats.counter += (value))
+
+/**
+ * Append formatted output to the buffer like snprintf but keep track of
+ * the total length even if the buffer is too small.
+ */
+
+static void stats_append(char *buffer, size_t size, size_t *length, const char *format, ...) {
+  va_list args;
+  size_t available = (*length < size) ? size - *length : 0;
+
+  va_start(args, format);
+  int count = vsnprintf(available ? buffer + *length : NULL, available, format, args);
+  va_end(args);
+
+  if (count > 0) *length += (size_t)count;
+}
+
+void tree_sitter_puppet_scanner_stats_reset(void) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+uint64_t tree_sitter_puppet_scanner_stats_chars(void) {
+  uint64_t chars = 0;
+
+  for (unsigned i = 0; i < SCAN_HELPER_COUNT; i++) {
+    chars += stats.helper_chars[i];
+  }
+  return chars;
+}
+
+size_t tree_sitter_puppet_scanner_stats_json(char *buffer, size_t size) {
+  size_t length = 0;
+
+  stats_append(buffer, size, &length,
+               "{\"scan_calls\": %llu, \"scan_failures\": %llu, \"returns\": {",
+               (unsigned long long)stats.scan_calls,
+               (unsigned long long)stats.scan_failures);
+  for (unsigned i = 0; i < TOKEN_TYPE_COUNT; i++) {
+    stats_append(buffer, size, &length, "%s\"%s\": %llu", i ? ", " : "",
+                 TOKEN_TYPE_NAMES[i], (unsigned long long)stats.scan_returns[i]);
+  }
+
+  stats_append(buffer, size, &length, "}, \"valid_symbols\": [");
+  for (uint32_t i = 0; i < stats.valid_symbols_used; i++) {
+    stats_append(buffer, size, &length, "%s{\"symbols\": \"", i ? ", " : "");
+    for (unsigned j = 0, first = 1; j < TOKEN_TYPE_COUNT; j++) {
+      if (stats.valid_symbols[i].mask & (1u << j)) {
+        stats_append(buffer, size, &length, "%s%s", first ? "" : "|", TOKEN_TYPE_NAMES[j]);
+        first = 0;
+      }
+    }
+    stats_append(buffer, size, &length, "\", \"calls\": %llu}",
+                 (unsigned long long)stats.valid_symbols[i].calls);
+  }
+
+  stats_append(buffer, size, &length, "], \"valid_symbols_overflow\": %llu, \"helpers\": {",
+               (unsigned long long)stats.valid_symbols_overflow);
+  for (unsigned i = 0; i < SCAN_HELPER_COUNT; i++) {
+    stats_append(buffer, size, &length, "%s\"%s\": {\"calls\": %llu, \"chars\": %llu}",
+                 i ? ", " : "", SCAN_HELPER_NAMES[i],
+                 (unsigned long long)stats.helper_calls[i],
+                 (unsigned long long)stats.helper_chars[i]);
+  }
+
+  stats_append(buffer, size, &length,
+               "}, \"serialize\": {\"calls\": %llu, \"bytes\": %llu}"
+               ", \"deserialize\": {\"calls\": %llu, \"bytes\": %llu}"
+               ", \"allocations\": {\"calls\": %llu, \"bytes\": %llu, \"frees\": %llu}}",
+               (unsigned long long)stats.serialize_calls,
+               (unsigned long long)stats.serialize_bytes,
+               (unsigned long long)stats.deserialize_calls,
+               (unsigned long long)stats.deserialize_bytes,
+               (unsigned long long)stats.alloc_calls,
+               (unsigned long long)stats.alloc_bytes,
+               (unsigned long long)stats.free_calls);
+
+  return length;
+}
+
+#else
+
+#define STATS_HELPER(helper) ((void)0)
+#define STATS_ADVANCE()      ((void)0)
+#define STATS_ADD(counter, value) ((void)0)
+
+#endif
+
+
+/**
+ * Advance the lexer to the next character. All scan functions use this
+ * wrapper, so the consumed characters can be counted.
+ */
+
+static inline void advance(TSLexer *lexer, bool skip) {
+  STATS_ADVANCE();
+  lexer->advance(lexer, skip);
+}
+
+
+/**
+ * The parser calls the scanner with all symbols valid when it is recovering
+ * from an error. This never happens during a normal parse.
+ */
+
+static inline bool is_error_recovery(const bool *valid_symbols) {
+  for (unsigned i = 0; i < TOKEN_TYPE_COUNT; i++) {
+    if (!valid_symbols[i]) return false;
+  }
+  return true;
+}
+
+
+/**
+ * Helper function to return the character classes of a character.
+ */
+
+static inline uint8_t char_class(int32_t c) {
+  return ((uint32_t)c < 128) ? CHAR_CLASSES[c] : 0;
+}
+
+/**
+ * Helper functions to check the class of a character.
+ */
+
+static inline bool is_space(int32_t c) {
+  return (char_class(c) & CHAR_SPACE) != 0;
+}
+
+static inline bool is_xdigit(int32_t c) {
+  return (char_class(c) & CHAR_XDIGIT) != 0;
+}
+
+static inline bool is_alnum(int32_t c) {
+  return (char_class(c) & (CHAR_ALPHA | CHAR_DIGIT)) != 0;
+}
+
 /**
  * Helper function to check if a character is valid for a Puppet variable
  * name ('a'..'z', '0'..'9', '_').
  */
 
 static inline bool is_variable_name(int32_t c) {
-  return ((isalpha(c) && islower(c)) || isdigit(c) || (c == U'_') || (c == U':'));
+  return (char_class(c) & CHAR_VARIABLE) != 0;
 }
 
 /**
@@ -109,7 +465,16 @@ static inline bool is_variable_name(int32_t c) {
  */
 
 static inline bool is_heredoc_word(int32_t c) {
-  return !((c == U':') || (c == U'/') || (c == U'\r') || (c == U'\n') || (c == U')'));
+  return (char_class(c) & CHAR_HEREDOC_STOP) == 0;
+}
+
+/**
+ * Helper function to return the bit of a heredoc escape character or 0 if
+ * the character is not a valid heredoc escape character.
+ */
+
+static inline uint8_t heredoc_escape_flag(int32_t c) {
+  return ((uint32_t)c < 128) ? HEREDOC_ESCAPE_FLAGS[c] : 0;
 }
 
 /**
@@ -117,27 +482,226 @@ static inline bool is_heredoc_word(int32_t c) {
  */
 
 static inline bool is_heredoc_escape(int32_t c) {
-  for(size_t i = 0; i < sizeof(HEREDOC_ESCAPES) / sizeof(int32_t); i++)
-  {
-    if (HEREDOC_ESCAPES[i] == c) {
-      return true;
+  return heredoc_escape_flag(c) != 0;
+}
+
+/**
+ * Helper functions to access the characters of a heredoc.
+ */
+
+static inline int32_t *heredoc_word(ScannerState *state, const Heredoc *heredoc) {
+  return &state->chars[heredoc->offset];
+}
+
+static inline int32_t *heredoc_indent(ScannerState *state, const Heredoc *heredoc) {
+  return &state->chars[heredoc->offset + heredoc->word_length];
+}
+
+static inline unsigned heredoc_chars(const Heredoc *heredoc) {
+  return heredoc->word_length + heredoc->indent_length;
+}
+
+/**
+ * Append a character to the heredoc that is currently being built after
+ * the open heredocs. Since the word and the indent are stored in this
+ * order, only the part that is currently scanned may grow. Return false if
+ * the character buffer is full or the character can't be serialized.
+ */
+
+static inline bool heredoc_append(ScannerState *state, Heredoc *heredoc, uint16_t *length, int32_t c) {
+  unsigned end = heredoc->offset + heredoc_chars(heredoc);
+
+  if (end >= HEREDOC_CHARS_SIZE) return false;
+  if (c < 0 || c > 0x10ffff) return false;
+
+  state->chars[end] = c;
+  (*length)++;
+  return true;
+}
+
+/**
+ * Remove the first open heredoc after its end tag has been found.
+ */
+
+static void heredoc_remove_first(ScannerState *state) {
+  unsigned length = heredoc_chars(&state->heredocs[0]);
+
+  state->chars_used -= length;
+  memmove(state->chars, state->chars + length, state->chars_used * sizeof(int32_t));
+
+  state->heredoc_count--;
+  memmove(state->heredocs, state->heredocs + 1, state->heredoc_count * sizeof(Heredoc));
+  for (unsigned i = 0; i < state->heredoc_count; i++) {
+    state->heredocs[i].offset -= length;
+  }
+}
+
+/**
+ * The serialized state uses a compact encoding. The state is empty if no
+ * heredoc is open and both flags are false, which is by far the most common
+ * case. Otherwise it starts with a header byte holding the format version
+ * and the two flags, followed by the number of open heredocs. Each heredoc
+ * then uses a flag byte, the escape bitmask if any escape is enabled and
+ * the end tag word and indent as UTF-8 bytes, each prefixed by its length
+ * in bytes. Numbers are stored as varints with 7 bits per byte.
+ */
+
+#define SERIALIZATION_VERSION 2
+
+#define STATE_INSIDE_INTERPOLATION_VARIABLE 0x01
+#define STATE_CHECK_SELBRACE                0x02
+
+#define HEREDOC_ALLOWS_INTERPOLATION 0x01
+#define HEREDOC_STARTED              0x02
+#define HEREDOC_END_VALID            0x04
+#define HEREDOC_HAS_ESCAPES          0x08
+
+static inline unsigned varint_size(unsigned value) {
+  unsigned size = 1;
+
+  while (value >= 0x80) {
+    value >>= 7;
+    size++;
+  }
+  return size;
+}
+
+static inline unsigned utf8_size(int32_t c) {
+  return (c < 0x80) ? 1 : (c < 0x800) ? 2 : (c < 0x10000) ? 3 : 4;
+}
+
+static unsigned utf8_string_size(const int32_t *chars, unsigned length) {
+  unsigned size = 0;
+
+  for (unsigned i = 0; i < length; i++) {
+    size += utf8_size(chars[i]);
+  }
+  return size;
+}
+
+/**
+ * Return the number of bytes the serialization of the state needs.
+ */
+
+static unsigned serialized_size(ScannerState *state, unsigned heredoc_count) {
+  if (heredoc_count == 0) {
+    return (state->inside_interpolation_variable || state->check_selbrace) ? 2 : 0;
+  }
+
+  unsigned size = 1 + varint_size(heredoc_count);
+
+  for (unsigned i = 0; i < heredoc_count; i++) {
+    Heredoc *heredoc = &state->heredocs[i];
+    unsigned word_size = utf8_string_size(heredoc_word(state, heredoc), heredoc->word_length);
+    unsigned indent_size = utf8_string_size(heredoc_indent(state, heredoc), heredoc->indent_length);
+
+    size += 1 + (heredoc->escapes ? 1 : 0);
+    size += varint_size(word_size) + word_size;
+    size += varint_size(indent_size) + indent_size;
+  }
+  return size;
+}
+
+static inline unsigned write_varint(char *buffer, unsigned value) {
+  unsigned size = 0;
+
+  while (value >= 0x80) {
+    buffer[size++] = (char)((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  buffer[size++] = (char)value;
+  return size;
+}
+
+static unsigned write_utf8_string(char *buffer, const int32_t *chars, unsigned length) {
+  unsigned size = write_varint(buffer, utf8_string_size(chars, length));
+
+  for (unsigned i = 0; i < length; i++) {
+    uint32_t c = (uint32_t)chars[i];
+
+    if (c < 0x80) {
+      buffer[size++] = (char)c;
+    } else if (c < 0x800) {
+      buffer[size++] = (char)(0xc0 | (c >> 6));
+      buffer[size++] = (char)(0x80 | (c & 0x3f));
+    } else if (c < 0x10000) {
+      buffer[size++] = (char)(0xe0 | (c >> 12));
+      buffer[size++] = (char)(0x80 | ((c >> 6) & 0x3f));
+      buffer[size++] = (char)(0x80 | (c & 0x3f));
+    } else {
+      buffer[size++] = (char)(0xf0 | (c >> 18));
+      buffer[size++] = (char)(0x80 | ((c >> 12) & 0x3f));
+      buffer[size++] = (char)(0x80 | ((c >> 6) & 0x3f));
+      buffer[size++] = (char)(0x80 | (c & 0x3f));
     }
   }
+  return size;
+}
+
+/**
+ * Read a varint from the buffer at *position. Return false if the buffer
+ * ends before the varint is complete.
+ */
+
+static bool read_varint(const char *buffer, unsigned length, unsigned *position, unsigned *value) {
+  *value = 0;
+
+  for (unsigned shift = 0; *position < length && shift < 32; shift += 7) {
+    uint8_t byte = (uint8_t)buffer[(*position)++];
+
+    *value |= (unsigned)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return true;
+  }
   return false;
 }
 
+/**
+ * Read a string written by write_utf8_string and append its characters to
+ * the buffer of the scanner state. Return false if the data is invalid or
+ * doesn't fit.
+ */
+
+static bool read_utf8_string(ScannerState *state, const char *buffer, unsigned length,
+                             unsigned *position, uint16_t *chars_length) {
+  unsigned size;
+
+  if (!read_varint(buffer, length, position, &size) || size > length - *position) {
+    return false;
+  }
+
+  const uint8_t *p = (const uint8_t *)&buffer[*position];
+  const uint8_t *end = p + size;
+
+  *position += size;
+  *chars_length = 0;
+
+  while (p < end) {
+    unsigned count = (*p < 0x80) ? 0 : (*p < 0xe0) ? 1 : (*p < 0xf0) ? 2 : 3;
+    uint32_t c = (count == 0) ? *p : (count == 1) ? (*p & 0x1f) :
+                 (count == 2) ? (*p & 0x0f) : (*p & 0x07);
+
+    if (count > (unsigned)(end - p - 1)) return false;
+    for (p++; count > 0; count--, p++) {
+      c = (c << 6) | (*p & 0x3f);
+    }
+    if (state->chars_used == HEREDOC_CHARS_SIZE) return false;
+
+    state->chars[state->chars_used++] = (int32_t)c;
+    (*chars_length)++;
+  }
+  return true;
+}
+
 /**
  * Check if a heredoc escape character is valid for the current heredoc, given
  * the escape flags specified for the heredoc.
  */
 
-static inline bool is_valid_heredoc_escape(UTF32String escapes, int32_t escape) {
-  for(size_t i = 0; i < escapes.size; i++) {
-    if (escape == *array_get(&escapes, i)) {
-      return true;
-    }
+static inline bool is_valid_heredoc_escape(const Heredoc *heredoc, int32_t escape) {
+  if (escape == U'\\') {
+    return (heredoc->escapes & HEREDOC_ESCAPE_BACKSLASH) != 0;
   }
-  return false;
+  return (heredoc->escapes & heredoc_escape_flag(escape)) != 0;
 }
 
 /**
@@ -145,25 +709,26 @@ static inline bool is_valid_heredoc_escape(UTF32String escapes, int32_t escape)
  */
 
 static bool scan_selbrace(TSLexer *lexer, ScannerState *state) {
+  STATS_HELPER(SCAN_SELBRACE);
   for(;;) {
     // We are done if the end of file is reached
     if (lexer->eof(lexer)) return false;
 
-    if (isspace(lexer->lookahead) || (lexer->lookahead == U'\n')) {
+    if (is_space(lexer->lookahead)) {
       // Skip whitespace
-      lexer->advance(lexer, true);
+      advance(lexer, true);
     }
     else if (lexer->lookahead == U'?') {
       state->check_selbrace = true;
       lexer->result_symbol = QMARK;
-      lexer->advance(lexer, false);
+      advance(lexer, false);
       return true;
     }
     else if (lexer->lookahead == U'{') {
       if (state->check_selbrace) {
         state->check_selbrace = false;
         lexer->result_symbol = SELBRACE;
-        lexer->advance(lexer, false);
+        advance(lexer, false);
         return true;
       }
 
@@ -186,7 +751,7 @@ static bool scan_interpolation_start(TSLexer *lexer) {
   if (lexer->lookahead != U'$') return false;
 
   lexer->mark_end(lexer);
-  lexer->advance(lexer, false);
+  advance(lexer, false);
 
   // We are done if the end of file is reached
   if (lexer->eof(lexer)) return false;
@@ -211,18 +776,19 @@ static bool scan_interpolation_start(TSLexer *lexer) {
  */
 
 static bool scan_interpolation(TSLexer *lexer, ScannerState *state) {
+  STATS_HELPER(SCAN_INTERPOLATION);
   // The interpolation must start with a '$'
   if (lexer->lookahead != U'$') return false;
 
   lexer->mark_end(lexer);
-  lexer->advance(lexer, false);
+  advance(lexer, false);
 
   // We found a possible interpolation, so scanning for a heredoc end word is
   // no longer valid.
-  if (state->open_heredocs.size > 0 &&
-      state->open_heredocs.contents[0].started &&
-      state->open_heredocs.contents[0].allows_interpolation) {
-    state->open_heredocs.contents[0].end_valid = false;
+  if (state->heredoc_count > 0 &&
+      state->heredocs[0].started &&
+      state->heredocs[0].allows_interpolation) {
+    state->heredocs[0].end_valid = false;
   }
 
   // We are done if the end of file is reached
@@ -231,7 +797,7 @@ static bool scan_interpolation(TSLexer *lexer, ScannerState *state) {
   // The style has not been defined yet so this must be the first
   // character after the '$'.
   if (lexer->lookahead == U'{') {
-    lexer->advance(lexer, false);
+    advance(lexer, false);
     lexer->mark_end(lexer);
     if (!is_variable_name(lexer->lookahead)) {
       lexer->result_symbol = INTERPOLATION_EXPRESSION;
@@ -250,8 +816,8 @@ static bool scan_interpolation(TSLexer *lexer, ScannerState *state) {
 	// last char in the string or heredoc, so return the appropriate content
 	// symbol.
     lexer->mark_end(lexer);
-    if (state->open_heredocs.size > 0 &&
-        state->open_heredocs.contents[0].started) {
+    if (state->heredoc_count > 0 &&
+        state->heredocs[0].started) {
       lexer->result_symbol = HEREDOC_CONTENT;
     } else {
       lexer->result_symbol = DQ_STRING;
@@ -272,7 +838,7 @@ static bool scan_interpolation(TSLexer *lexer, ScannerState *state) {
       lexer->result_symbol = INTERPOLATION_EXPRESSION;
       return true;
     }
-    lexer->advance(lexer, false);
+    advance(lexer, false);
   }
 }
 
@@ -282,13 +848,14 @@ static bool scan_interpolation(TSLexer *lexer, ScannerState *state) {
  */
 
 static bool scan_sq_escape_sequence(TSLexer *lexer) {
+  STATS_HELPER(SCAN_SQ_ESCAPE_SEQUENCE);
   // We are done if the end of file is reached
   if (lexer->eof(lexer)) return false;
 
   // It's only an escape sequence if it starts with a backslash
   if (lexer->lookahead != U'\\') return false;
 
-  lexer->advance(lexer, false);
+  advance(lexer, false);
 
   // We are done if the end of file is reached
   if (lexer->eof(lexer)) return false;
@@ -307,7 +874,7 @@ static bool scan_sq_escape_sequence(TSLexer *lexer) {
   }
 
   // The following character belongs to the escape sequence
-  lexer->advance(lexer, false);
+  advance(lexer, false);
 
   lexer->result_symbol = SQ_ESCAPE_SEQUENCE;
   return true;
@@ -319,19 +886,20 @@ static bool scan_sq_escape_sequence(TSLexer *lexer) {
  */
 
 static bool scan_dq_escape_sequence(TSLexer *lexer) {
+  STATS_HELPER(SCAN_DQ_ESCAPE_SEQUENCE);
   // We are done if the end of file is reached
   if (lexer->eof(lexer)) return false;
 
   // It's only an escape sequence if it starts with a backslash
   if (lexer->lookahead != U'\\') return false;
 
-  lexer->advance(lexer, false);
+  advance(lexer, false);
 
   // We are done if the end of file is reached
   if (lexer->eof(lexer)) return false;
 
   // The following character belongs to the escape sequence
-  lexer->advance(lexer, false);
+  advance(lexer, false);
 
   lexer->result_symbol = DQ_ESCAPE_SEQUENCE;
   return true;
@@ -343,14 +911,14 @@ static bool scan_dq_escape_sequence(TSLexer *lexer) {
 
 static bool scan_newline(TSLexer *lexer, bool skip) {
   if (lexer->lookahead == U'\r') {
-    lexer->advance(lexer, skip);
+    advance(lexer, skip);
     if (lexer->lookahead == U'\n') {
-      lexer->advance(lexer, skip);
+      advance(lexer, skip);
     } else {
       return false;
     }
   } else if (lexer->lookahead == U'\n') {
-    lexer->advance(lexer, skip);
+    advance(lexer, skip);
   } else {
     return false;
   }
@@ -362,7 +930,11 @@ static bool scan_newline(TSLexer *lexer, bool skip) {
  */
 
 static bool scan_heredoc_escape_sequence(TSLexer *lexer, ScannerState *state) {
-  Heredoc *heredoc = array_get(&state->open_heredocs, 0);
+  STATS_HELPER(SCAN_HEREDOC_ESCAPE_SEQUENCE);
+  Heredoc *heredoc = &state->heredocs[0];
+
+  // There is no escape sequence outside of a heredoc
+  if (state->heredoc_count == 0) return false;
 
   // We are done if the end of file is reached
   if (lexer->eof(lexer)) return false;
@@ -373,7 +945,7 @@ static bool scan_heredoc_escape_sequence(TSLexer *lexer, ScannerState *state) {
   // Mark the end of our token, as we don't know yet whether this is a
   // supported escape sequence
   lexer->mark_end(lexer);
-  lexer->advance(lexer, false);
+  advance(lexer, false);
 
   // We are done if the end of file is reached
   if (lexer->eof(lexer)) return false;
@@ -382,7 +954,7 @@ static bool scan_heredoc_escape_sequence(TSLexer *lexer, ScannerState *state) {
   if (scan_newline(lexer, false)) {
     heredoc->end_valid = true;
     lexer->mark_end(lexer);
-    if (is_valid_heredoc_escape(heredoc->escapes, U'L')) {
+    if (is_valid_heredoc_escape(heredoc, U'L')) {
       lexer->result_symbol = HEREDOC_ESCAPE_SEQUENCE;
       return true;
     } else {
@@ -392,30 +964,30 @@ static bool scan_heredoc_escape_sequence(TSLexer *lexer, ScannerState *state) {
   }
 
   // Scan for an escape other than a newline
-  if (is_valid_heredoc_escape(heredoc->escapes, lexer->lookahead)) {
+  if (is_valid_heredoc_escape(heredoc, lexer->lookahead)) {
     // Scan for Unicode escape sequences: \uXXXX or \u{XXXXXX}
     if (lexer->lookahead == U'u') {
-      lexer->advance(lexer, false);
-      if (isxdigit((char)lexer->lookahead)) {
-        for(size_t i = 0; i < 4 && isxdigit((char)lexer->lookahead); i++) {
-          lexer->advance(lexer, false);
+      advance(lexer, false);
+      if (is_xdigit(lexer->lookahead)) {
+        for(size_t i = 0; i < 4 && is_xdigit(lexer->lookahead); i++) {
+          advance(lexer, false);
         }
       } else if (lexer->lookahead == U'{') {
-        lexer->advance(lexer, false);
-        for(size_t i = 0; i < 6 && isxdigit((char)lexer->lookahead); i++) {
-          lexer->advance(lexer, false);
+        advance(lexer, false);
+        for(size_t i = 0; i < 6 && is_xdigit(lexer->lookahead); i++) {
+          advance(lexer, false);
         }
         if (lexer->lookahead == U'}') {
-          lexer->advance(lexer, false);
+          advance(lexer, false);
         }
       }
     } else {
       // Consume single character escape sequence
-      lexer->advance(lexer, false);
+      advance(lexer, false);
     }
     lexer->result_symbol = HEREDOC_ESCAPE_SEQUENCE;
   } else {
-    lexer->advance(lexer, false);
+    advance(lexer, false);
     lexer->result_symbol = HEREDOC_CONTENT;
   }
   lexer->mark_end(lexer);
@@ -433,17 +1005,19 @@ static bool scan_heredoc_escape_sequence(TSLexer *lexer, ScannerState *state) {
  */
 
 static bool scan_sq_string(TSLexer *lexer) {
+  STATS_HELPER(SCAN_SQ_STRING);
   lexer->result_symbol = SQ_STRING;
 
   for(bool has_content=false;; has_content=true) {
-    // We are done if the end of file is reached
-    if (lexer->eof(lexer)) return false;
+    // We are done if the end of file is reached. The content is returned
+    // anyway, so an unterminated string is only scanned once.
+    if (lexer->eof(lexer)) return has_content;
 
     if ((lexer->lookahead == U'\'') || (lexer->lookahead == U'\\')) {
       return has_content;
     }
 
-    lexer->advance(lexer, false);
+    advance(lexer, false);
   }
 }
 
@@ -453,6 +1027,7 @@ static bool scan_sq_string(TSLexer *lexer) {
  */
 
 static bool scan_interpolation_nosigil_variable(TSLexer *lexer, ScannerState *state) {
+  STATS_HELPER(SCAN_INTERPOLATION_NOSIGIL_VARIABLE);
   lexer->result_symbol = INTERPOLATION_NOSIGIL_VARIABLE;
 
   // Mark the end so we return a zero-width token, and then scan for the name
@@ -475,7 +1050,7 @@ static bool scan_interpolation_nosigil_variable(TSLexer *lexer, ScannerState *st
         return false;
       }
     }
-    lexer->advance(lexer, false);
+    advance(lexer, false);
   }
 }
 
@@ -486,11 +1061,16 @@ static bool scan_interpolation_nosigil_variable(TSLexer *lexer, ScannerState *st
  */
 
 static bool scan_dq_string(TSLexer *lexer) {
+  STATS_HELPER(SCAN_DQ_STRING);
   lexer->result_symbol = DQ_STRING;
 
   for(bool has_content=false;; has_content=true) {
-    // We are done if the end of file is reached
-    if (lexer->eof(lexer)) return false;
+    // We are done if the end of file is reached. The content is returned
+    // anyway, so an unterminated string is only scanned once.
+    if (lexer->eof(lexer)) {
+      lexer->mark_end(lexer);
+      return has_content;
+    }
 
     if (lexer->lookahead == U'"') {
       lexer->mark_end(lexer);
@@ -510,57 +1090,79 @@ static bool scan_dq_string(TSLexer *lexer) {
       lexer->mark_end(lexer);
       return has_content;
     }
-    lexer->advance(lexer, false);
+    advance(lexer, false);
   }
 }
 
 
+/**
+ * Advance to the next character unless the budget of characters is used up.
+ * A NULL budget has no limit.
+ */
+
+static inline bool advance_bounded(TSLexer *lexer, unsigned *budget) {
+  if (budget) {
+    if (*budget == 0) return false;
+    (*budget)--;
+  }
+  advance(lexer, false);
+  return true;
+}
+
 /**
  * Scan from the beginning of a line for a heredoc end tag, return true if
  * found. If heredoc has not already been started, determine whether the
  * heredoc has an indent. If an indent is found, add the indent characters to
- * heredoc.indent.
+ * the heredoc. If budget is not NULL, it is the number of characters that
+ * may still be read and the scan fails when it is used up.
  */
 
-static bool scan_heredoc_end_tag(TSLexer *lexer, Heredoc *heredoc, bool mark) {
+static bool scan_heredoc_end_tag(TSLexer *lexer, ScannerState *state, Heredoc *heredoc, bool mark,
+                                 unsigned *budget) {
+  if (!heredoc->started) {
+    heredoc->indent_length = 0;
+  }
   while (lexer->lookahead == U' ' || lexer->lookahead == U'\t') {
     if (!heredoc->started) {
-      array_push(&heredoc->indent, lexer->lookahead);
+      if (!heredoc_append(state, heredoc, &heredoc->indent_length, lexer->lookahead)) {
+        return false;
+      }
     }
-    lexer->advance(lexer, false);
+    if (!advance_bounded(lexer, budget)) return false;
   }
   if (lexer->lookahead == U'|') {
-    lexer->advance(lexer, false);
+    if (!advance_bounded(lexer, budget)) return false;
     while (lexer->lookahead == U' ' || lexer->lookahead == U'\t') {
-      lexer->advance(lexer, false);
+      if (!advance_bounded(lexer, budget)) return false;
     }
   } else {
     // heredoc not indented, so clear possible indent chars
     if (! heredoc->started) {
-      array_clear(&heredoc->indent);
+      heredoc->indent_length = 0;
     }
   }
   if (lexer->lookahead == U'-') {
-    lexer->advance(lexer, false);
+    if (!advance_bounded(lexer, budget)) return false;
   }
   while (lexer->lookahead == U' ' || lexer->lookahead == U'\t') {
-    lexer->advance(lexer, false);
+    if (!advance_bounded(lexer, budget)) return false;
   }
+  const int32_t *word = heredoc_word(state, heredoc);
   size_t position_in_word = 0;
-  for(; position_in_word < heredoc->word.size; position_in_word++) {
-    if (lexer->lookahead == *array_get(&heredoc->word, position_in_word)) {
-      lexer->advance(lexer, false);
+  for(; position_in_word < heredoc->word_length; position_in_word++) {
+    if (lexer->lookahead == word[position_in_word]) {
+      if (!advance_bounded(lexer, budget)) return false;
     } else {
       break;
     }
   }
-  if (position_in_word == heredoc->word.size) {
+  if (position_in_word == heredoc->word_length) {
     // Mark end of possible tag
     if (mark) {
       lexer->mark_end(lexer);
     }
     while (lexer->lookahead == U' ' || lexer->lookahead == U'\t') {
-      lexer->advance(lexer, false);
+      if (!advance_bounded(lexer, budget)) return false;
     }
     if (lexer->eof(lexer) || scan_newline(lexer, true)) {
       return true;
@@ -570,23 +1172,95 @@ static bool scan_heredoc_end_tag(TSLexer *lexer, Heredoc *heredoc, bool mark) {
 }
 
 /**
- * Scan for the heredoc end tag, to determine if an indent is present.
+ * Check if scan_heredoc_end_tag consumes the character c at the beginning
+ * of a line. This is the case for all characters that can start an end tag.
  */
 
-static bool scan_heredoc_end_tag_indent(TSLexer *lexer, Heredoc *heredoc) {
-  for (;;) {
-    if (lexer->eof(lexer)) return false;
+static inline bool is_heredoc_end_tag_start(ScannerState *state, const Heredoc *heredoc, int32_t c) {
+  return (c == U' ') || (c == U'\t') || (c == U'|') || (c == U'-') ||
+    (c == heredoc_word(state, heredoc)[0]);
+}
 
-    // End tag must occur after a newline
-    if (scan_newline(lexer, true)) {
-      if (scan_heredoc_end_tag(lexer, heredoc, false)) {
-        return true;
+/**
+ * Insert the indent that has been scanned into the copy of the first open
+ * heredoc after its word. The copy is stored after all open heredocs, so
+ * the characters of the other heredocs move up to make room. Keep the
+ * heredoc without an indent if there is no room for it or the state could
+ * no longer be serialized.
+ */
+
+static void heredoc_insert_indent(ScannerState *state, const Heredoc *copy) {
+  Heredoc *heredoc = &state->heredocs[0];
+  unsigned length = copy->indent_length;
+  unsigned end = heredoc->offset + heredoc->word_length;
+  unsigned copy_end = copy->offset + heredoc_chars(copy);
+
+  if (length == 0 || copy_end + length > HEREDOC_CHARS_SIZE) return;
+
+  // Move everything after the word up, so the indent of the copy doesn't
+  // overlap the place of the indent
+  memmove(&state->chars[end + length], &state->chars[end], (copy_end - end) * sizeof(int32_t));
+  memcpy(&state->chars[end], heredoc_indent(state, copy) + length, length * sizeof(int32_t));
+
+  heredoc->indent_length = (uint16_t)length;
+  state->chars_used += length;
+  for (unsigned i = 1; i < state->heredoc_count; i++) {
+    state->heredocs[i].offset += length;
+  }
+
+  if (serialized_size(state, state->heredoc_count) > TREE_SITTER_SERIALIZATION_BUFFER_SIZE) {
+    memmove(&state->chars[end], &state->chars[end + length],
+            (state->chars_used - end) * sizeof(int32_t));
+    heredoc->indent_length = 0;
+    state->chars_used -= length;
+    for (unsigned i = 1; i < state->heredoc_count; i++) {
+      state->heredocs[i].offset -= length;
+    }
+  }
+}
+
+/**
+ * Scan for the end tag of the first open heredoc at the start of its body,
+ * to determine if an indent is present. The look-ahead belongs to the token
+ * that starts the body, so an edit of the body only invalidates that token
+ * and the content. The heredoc tag, the tokens between the tag and the
+ * body and the other heredocs on the same line keep their state, because
+ * the state doesn't hold the indent before the body starts. Give up on the
+ * indent if the end tag has not been found after reading
+ * HEREDOC_INDENT_SCAN_LIMIT characters, with a line break counting as one,
+ * or at the end of file. The heredoc is then accepted without an indent.
+ */
+
+static void scan_heredoc_end_tag_indent(TSLexer *lexer, ScannerState *state) {
+  STATS_HELPER(SCAN_HEREDOC_END_TAG_INDENT);
+  Heredoc *heredoc = &state->heredocs[0];
+  Heredoc copy = *heredoc;
+
+  // The indent is collected in a copy of the heredoc after the open heredocs
+  if (state->chars_used + heredoc->word_length > HEREDOC_CHARS_SIZE) return;
+  copy.offset = state->chars_used;
+  copy.indent_length = 0;
+  memcpy(heredoc_word(state, &copy), heredoc_word(state, heredoc),
+         heredoc->word_length * sizeof(int32_t));
+
+  bool line_start = true;
+
+  // The end tag check counts the characters it reads against the budget,
+  // so a line with a long run of blanks can't extend the look-ahead
+  for (unsigned budget = HEREDOC_INDENT_SCAN_LIMIT; budget > 0; budget--) {
+    if (lexer->eof(lexer)) break;
+
+    // End tag must occur at the beginning of a line
+    if (line_start) {
+      if (scan_heredoc_end_tag(lexer, state, &copy, false, &budget)) {
+        heredoc_insert_indent(state, &copy);
+        return;
       }
-    } else {
-      lexer->advance(lexer, false);
+      if (budget == 0) break;
     }
+    line_start = scan_newline(lexer, true);
+    if (!line_start) advance(lexer, false);
   }
-  return false;
 }
 
 /**
@@ -597,85 +1271,90 @@ static bool scan_heredoc_end_tag_indent(TSLexer *lexer, Heredoc *heredoc) {
  */
 
 static bool scan_heredoc_start(TSLexer *lexer, ScannerState *state) {
+  STATS_HELPER(SCAN_HEREDOC_START);
   lexer->result_symbol = HEREDOC_START;
-  Heredoc heredoc = {0};
-  UTF32String word = array_new();
-  UTF32String escapes = array_new();
 
   // We are done if the end of file is reached
   if (lexer->eof(lexer)) return false;
 
+  // No room for another heredoc
+  if (state->heredoc_count == MAX_OPEN_HEREDOCS) return false;
+
+  // The new heredoc is built in place after the open heredocs. It only
+  // becomes one of them if the complete tag has been found.
+  Heredoc *heredoc = &state->heredocs[state->heredoc_count];
+  memset(heredoc, 0, sizeof(Heredoc));
+  heredoc->offset = state->chars_used;
+  int32_t *word = heredoc_word(state, heredoc);
+
   while (lexer->lookahead == U' ' || lexer->lookahead == U'\t') {
-    lexer->advance(lexer, true);
+    advance(lexer, true);
   }
   while (is_heredoc_word(lexer->lookahead)) {
-    array_push(&word, lexer->lookahead);
-    lexer->advance(lexer, false);
+    if (heredoc->word_length == MAX_HEREDOC_WORD_LENGTH ||
+        !heredoc_append(state, heredoc, &heredoc->word_length, lexer->lookahead)) {
+      return false;
+    }
+    advance(lexer, false);
   }
   // The Puppet parser performs a word.rstrip!
-  while (word.size > 0 &&
-      (*array_get(&word, word.size - 1) == U' ' ||
-       *array_get(&word, word.size - 1) == U'\t')) {
-    array_erase(&word, word.size - 1);
+  while (heredoc->word_length > 0 &&
+      (word[heredoc->word_length - 1] == U' ' ||
+       word[heredoc->word_length - 1] == U'\t')) {
+    heredoc->word_length--;
   }
-  if (word.size > 1 && *array_get(&word, 0) == U'"' &&
-      *array_get(&word, word.size - 1) == U'"') {
+  if (heredoc->word_length > 1 && word[0] == U'"' &&
+      word[heredoc->word_length - 1] == U'"') {
     // The quote character indicates that interpolation can be used
-    heredoc.allows_interpolation = true;
-    array_erase(&word, 0);
-    array_erase(&word, word.size - 1);
+    heredoc->allows_interpolation = true;
+    heredoc->word_length -= 2;
+    memmove(word, word + 1, heredoc->word_length * sizeof(int32_t));
   }
-  if (word.size == 0) {
-    array_delete(&word);
+  if (heredoc->word_length == 0) {
     return false;
   }
   while (lexer->lookahead == U' ' || lexer->lookahead == U'\t') {
-    lexer->advance(lexer, true);
+    advance(lexer, true);
   }
   if (lexer->lookahead == U':') {
-    lexer->advance(lexer, false);
+    advance(lexer, false);
     // Scan till the end of the syntax file type
-    while (isalnum(lexer->lookahead)) {
-      lexer->advance(lexer, false);
+    while (is_alnum(lexer->lookahead)) {
+      advance(lexer, false);
     }
   }
   while (lexer->lookahead == U' ' || lexer->lookahead == U'\t') {
-    lexer->advance(lexer, true);
+    advance(lexer, true);
   }
   if (lexer->lookahead == U'/') {
-    lexer->advance(lexer, false);
+    advance(lexer, false);
     // Scan till the end of the escape flags
-    while (is_heredoc_escape((char)lexer->lookahead)) {
-      array_push(&escapes, lexer->lookahead);
-      lexer->advance(lexer, false);
+    while (is_heredoc_escape(lexer->lookahead)) {
+      heredoc->escapes |= heredoc_escape_flag(lexer->lookahead);
+      advance(lexer, false);
     }
     // We seem to have found a bare '/', so enable all escape sequences
-    if (escapes.size == 0) {
-      for(size_t i = 0; i < sizeof(HEREDOC_ESCAPES) / sizeof(int32_t); i++)
-      {
-        array_push(&escapes, HEREDOC_ESCAPES[i]);
-      }
+    if (heredoc->escapes == 0) {
+      heredoc->escapes = HEREDOC_ESCAPES_ALL;
     }
     // Add the backslash escape, which is valid for any enabled escape sequence
-    array_push(&escapes, U'\\');
+    heredoc->escapes |= HEREDOC_ESCAPE_BACKSLASH;
   }
   while (lexer->lookahead == U' ' || lexer->lookahead == U'\t') {
-    lexer->advance(lexer, true);
+    advance(lexer, true);
   }
   if (lexer->lookahead == U')') {
     // We seem to have found the end of the heredoc tag
-    if (word.size > 0) {
-      lexer->mark_end(lexer);
-      heredoc.word = word;
-      heredoc.escapes = escapes;
-      heredoc.indent = (UTF32String)array_new();
-      if (scan_heredoc_end_tag_indent(lexer, &heredoc)) {
-        array_push(&state->open_heredocs, heredoc);
-        return true;
-      }
+    lexer->mark_end(lexer);
+    // Only accept the heredoc if the state can still be serialized
+    if (serialized_size(state, state->heredoc_count + 1) >
+        TREE_SITTER_SERIALIZATION_BUFFER_SIZE) {
+      return false;
     }
+    state->heredoc_count++;
+    state->chars_used += heredoc_chars(heredoc);
+    return true;
   }
-  array_delete(&word);
   return false;
 }
 
@@ -685,32 +1364,65 @@ static bool scan_heredoc_start(TSLexer *lexer, ScannerState *state) {
  * supports interpolation and a '$' is found or if an escape sequence is found.
  * The scanner then uses the scan_interpolation or scan_heredoc_escape_sequence
  * to continue scanning and returns here later. However, set the result symbol
- * to HEREDOC_BODY_END if the heredoc end tag is found.
+ * to HEREDOC_BODY_END if the heredoc end tag is found. The indent_skipped
+ * flag indicates that the indent of the heredoc has already been skipped at
+ * the beginning of the line.
+ *
+ * The content token spans multiple lines. After each newline the next line
+ * is checked for the end tag. The token ends before that line if the end tag
+ * is found or if the line continues with an escape sequence or interpolation.
+ * The next call then handles the line from its beginning, so the indent is
+ * skipped as usual. A heredoc without escapes has no escape sequences, so a
+ * backslash and the following character are part of the content token.
  */
 
-static inline bool scan_heredoc_content(TSLexer *lexer, ScannerState *state) {
-  Heredoc *heredoc = array_get(&state->open_heredocs, 0);
+static inline bool scan_heredoc_content(TSLexer *lexer, ScannerState *state, bool indent_skipped) {
+  STATS_HELPER(SCAN_HEREDOC_CONTENT);
+  Heredoc *heredoc = &state->heredocs[0];
   bool has_content = false;
+  bool has_lines = false;
 
   lexer->mark_end(lexer);
   for (;;) {
-    if (lexer->eof(lexer)) return false;
+    // We are done if the end of file is reached. Complete lines are still
+    // returned as content.
+    if (lexer->eof(lexer)) {
+      if (has_lines) {
+        heredoc->end_valid = true;
+        lexer->result_symbol = HEREDOC_CONTENT;
+        return true;
+      }
+      return false;
+    }
 
     if (heredoc->end_valid) {
-      if (scan_heredoc_end_tag(lexer, heredoc, true)) {
-        array_delete(&heredoc->word);
-        array_erase(&state->open_heredocs, 0);
+      bool end_tag_start = is_heredoc_end_tag_start(state, heredoc, lexer->lookahead);
+
+      if (scan_heredoc_end_tag(lexer, state, heredoc, true, NULL)) {
+        heredoc_remove_first(state);
         lexer->result_symbol = HEREDOC_BODY_END;
         return true;
       }
-      // Check if we have consumed any content
-      if (lexer->get_column(lexer) > 0) {
+      // Check if we have consumed any content: the end tag check always
+      // starts at the beginning of a line, so this is either the skipped
+      // indent or the part of the line that looked like an end tag
+      if (indent_skipped || end_tag_start) {
         has_content = true;
       }
       heredoc->end_valid = false;
     }
     // Possible heredoc escape sequence found
     if (lexer->lookahead == U'\\') {
+      // Without escapes the backslash and the next character are content
+      if (heredoc->escapes == 0) {
+        advance(lexer, false);
+        has_content = true;
+        if (lexer->lookahead != U'\r' && lexer->lookahead != U'\n' &&
+            !lexer->eof(lexer)) {
+          advance(lexer, false);
+        }
+        continue;
+      }
       lexer->mark_end(lexer);
       if (has_content) {
         lexer->result_symbol = HEREDOC_CONTENT;
@@ -728,30 +1440,44 @@ static inline bool scan_heredoc_content(TSLexer *lexer, ScannerState *state) {
       return false;
     }
     if (scan_newline(lexer, false)) {
-      heredoc->end_valid = true;
       lexer->mark_end(lexer);
-      lexer->result_symbol = HEREDOC_CONTENT;
-      return true;
+      has_content = true;
+      has_lines = true;
+
+      // Stop before the next line if it has the end tag or if it continues
+      // with an escape sequence or interpolation
+      if (scan_heredoc_end_tag(lexer, state, heredoc, false, NULL) ||
+          (lexer->lookahead == U'\\' && heredoc->escapes != 0) ||
+          (lexer->lookahead == U'$' && heredoc->allows_interpolation)) {
+        heredoc->end_valid = true;
+        lexer->result_symbol = HEREDOC_CONTENT;
+        return true;
+      }
+      continue;
     }
-    lexer->advance(lexer, false);
-    lexer->mark_end(lexer);
+    advance(lexer, false);
     has_content = true;
   }
 }
 
 
 /**
- * Scan for the beginning of a heredoc body, following a newline
+ * Scan for the beginning of a heredoc body, following a newline. The token
+ * ends after the newline and the scanner reads ahead to the end tag to
+ * determine the indent of the body.
  */
 
 static inline bool scan_heredoc_body_start(TSLexer *lexer, ScannerState *state) {
+  STATS_HELPER(SCAN_HEREDOC_BODY_START);
   while (lexer->lookahead == U' ' || lexer->lookahead == U'\t') {
-    lexer->advance(lexer, true);
+    advance(lexer, true);
   }
   if (scan_newline(lexer, true)) {
+    lexer->mark_end(lexer);
+    scan_heredoc_end_tag_indent(lexer, state);
     lexer->result_symbol = HEREDOC_BODY_START;
-    state->open_heredocs.contents[0].started = true;
-    state->open_heredocs.contents[0].end_valid = true;
+    state->heredocs[0].started = true;
+    state->heredocs[0].end_valid = true;
     return true;
   } else {
     return false;
@@ -763,130 +1489,160 @@ static inline bool scan_heredoc_body_start(TSLexer *lexer, ScannerState *state)
  * The public interface used by the tree-sitter parser
  */
 
+/**
+ * The scanner state is the only allocation of the scanner. All buffers of
+ * the open heredocs are part of it, so scanning and deserializing never
+ * allocate and a deserialize resets the buffers by resetting the counts.
+ */
+
 void *tree_sitter_puppet_external_scanner_create() {
   ScannerState *state = ts_malloc(sizeof(ScannerState));
-  array_init(&state->open_heredocs);
+  STATS_ADD(alloc_calls, 1);
+  STATS_ADD(alloc_bytes, sizeof(ScannerState));
+  state->inside_interpolation_variable = false;
+  state->check_selbrace = false;
+  state->heredoc_count = 0;
+  state->chars_used = 0;
   return state;
 }
 
 void tree_sitter_puppet_external_scanner_destroy(void *payload) {
-  ScannerState *state = (ScannerState*)payload;
-  for (uint32_t i = 0; i < state->open_heredocs.size; i++) {
-    array_delete(&array_get(&state->open_heredocs, i)->word);
-    array_delete(&array_get(&state->open_heredocs, i)->indent);
-    array_delete(&array_get(&state->open_heredocs, i)->escapes);
-  }
-  array_delete(&state->open_heredocs);
-  ts_free(state);
+  STATS_ADD(free_calls, 1);
+  ts_free(payload);
 }
 
 unsigned tree_sitter_puppet_external_scanner_serialize(void *payload, char *buffer) {
   ScannerState *state = (ScannerState*)payload;
   unsigned size = 0;  // total size of the serialized data in bytes
 
-  buffer[size++] = (char)state->inside_interpolation_variable;
-  buffer[size++] = (char)state->check_selbrace;
-  buffer[size++] = (char)state->open_heredocs.size;
-  for (uint32_t i = 0; i < state->open_heredocs.size; i++) {
-    Heredoc *heredoc = array_get(&state->open_heredocs, i);
-    if (size + 2 + heredoc->word.size + heredoc->indent.size +
-        heredoc->escapes.size >= TREE_SITTER_SERIALIZATION_BUFFER_SIZE) {
-      return 0;
-    }
-    buffer[size++] = (char)heredoc->allows_interpolation;
-    buffer[size++] = (char)heredoc->started;
-    buffer[size++] = (char)heredoc->end_valid;
-    buffer[size++] = (char)heredoc->word.size;
-    memcpy(&buffer[size], heredoc->word.contents,
-      heredoc->word.size * array_elem_size(&heredoc->word));
-    size += heredoc->word.size * array_elem_size(&heredoc->word);
-    buffer[size++] = (char)heredoc->indent.size;
-    memcpy(&buffer[size], heredoc->indent.contents,
-      heredoc->indent.size * array_elem_size(&heredoc->indent));
-    size += heredoc->indent.size * array_elem_size(&heredoc->indent);
-    buffer[size++] = (char)heredoc->escapes.size;
-    memcpy(&buffer[size], heredoc->escapes.contents,
-      heredoc->escapes.size * array_elem_size(&heredoc->escapes));
-    size += heredoc->escapes.size * array_elem_size(&heredoc->escapes);
+  STATS_ADD(serialize_calls, 1);
+
+  // Nothing to save for the initial state
+  if (state->heredoc_count == 0 &&
+      !state->inside_interpolation_variable && !state->check_selbrace) {
+    return 0;
   }
 
+  // The state always fits into the buffer since a new heredoc is only
+  // accepted if the serialization of the resulting state fits.
+  buffer[size++] = (char)((SERIALIZATION_VERSION << 4) |
+    (state->inside_interpolation_variable ? STATE_INSIDE_INTERPOLATION_VARIABLE : 0) |
+    (state->check_selbrace ? STATE_CHECK_SELBRACE : 0));
+  size += write_varint(&buffer[size], state->heredoc_count);
+
+  for (unsigned i = 0; i < state->heredoc_count; i++) {
+    Heredoc *heredoc = &state->heredocs[i];
+
+    buffer[size++] = (char)(
+      (heredoc->allows_interpolation ? HEREDOC_ALLOWS_INTERPOLATION : 0) |
+      (heredoc->started ? HEREDOC_STARTED : 0) |
+      (heredoc->end_valid ? HEREDOC_END_VALID : 0) |
+      (heredoc->escapes ? HEREDOC_HAS_ESCAPES : 0));
+    if (heredoc->escapes) {
+      buffer[size++] = (char)heredoc->escapes;
+    }
+    size += write_utf8_string(&buffer[size], heredoc_word(state, heredoc), heredoc->word_length);
+    size += write_utf8_string(&buffer[size], heredoc_indent(state, heredoc), heredoc->indent_length);
+  }
+
+  STATS_ADD(serialize_bytes, size);
   return size;
 }
 
 void tree_sitter_puppet_external_scanner_deserialize(void *payload, const char *buffer, unsigned length) {
   ScannerState *state = (ScannerState*)payload;
+  unsigned position = 0, heredoc_count;
+
+  STATS_ADD(deserialize_calls, 1);
+  STATS_ADD(deserialize_bytes, length);
 
   // Initialize the structure since the deserialization function will
   // sometimes also be called with length set to zero.
   state->inside_interpolation_variable = false;
   state->check_selbrace = false;
-  for (uint32_t i = 0; i < state->open_heredocs.size; i++) {
-    array_delete(&array_get(&state->open_heredocs, i)->word);
-    array_delete(&array_get(&state->open_heredocs, i)->indent);
-    array_delete(&array_get(&state->open_heredocs, i)->escapes);
-  }
-  array_delete(&state->open_heredocs);
+  state->heredoc_count = 0;
+  state->chars_used = 0;
 
   if (length == 0) {
     return;
   }
 
-  unsigned size = 0;
-  state->inside_interpolation_variable = buffer[size++];
-  state->check_selbrace = buffer[size++];
-  uint8_t open_heredoc_count = buffer[size++];
-  for (unsigned j = 0; j < open_heredoc_count; j++) {
-    Heredoc heredoc = {0};
-    heredoc.allows_interpolation = buffer[size++];
-    heredoc.started = buffer[size++];
-    heredoc.end_valid = buffer[size++];
-    heredoc.word = (UTF32String)array_new();
-    uint8_t word_length = buffer[size++];
-    array_reserve(&heredoc.word, word_length);
-    memcpy(heredoc.word.contents, &buffer[size],
-      word_length * array_elem_size(&heredoc.word));
-    heredoc.word.size = word_length;
-    size += heredoc.word.size * array_elem_size(&heredoc.word);
-    heredoc.indent = (UTF32String)array_new();
-    uint8_t indent_length = buffer[size++];
-    array_reserve(&heredoc.indent, indent_length);
-    memcpy(heredoc.indent.contents, &buffer[size],
-      indent_length * array_elem_size(&heredoc.indent));
-    heredoc.indent.size = indent_length;
-    size += heredoc.indent.size * array_elem_size(&heredoc.indent);
-    heredoc.escapes = (UTF32String)array_new();
-    uint8_t escapes_length = buffer[size++];
-    array_reserve(&heredoc.escapes, escapes_length);
-    memcpy(heredoc.escapes.contents, &buffer[size],
-      escapes_length * array_elem_size(&heredoc.escapes));
-    heredoc.escapes.size = escapes_length;
-    size += heredoc.escapes.size * array_elem_size(&heredoc.escapes);
-    array_push(&state->open_heredocs, heredoc);
-  }
-
-  assert(size == length);
+  // Ignore a state written by a different version of the scanner
+  uint8_t header = (uint8_t)buffer[position++];
+  if ((header >> 4) != SERIALIZATION_VERSION) {
+    return;
+  }
+
+  if (!read_varint(buffer, length, &position, &heredoc_count) ||
+      heredoc_count > MAX_OPEN_HEREDOCS) {
+    return;
+  }
+
+  for (unsigned i = 0; i < heredoc_count; i++) {
+    Heredoc *heredoc = &state->heredocs[i];
+
+    if (position >= length) break;
+
+    uint8_t flags = (uint8_t)buffer[position++];
+    heredoc->allows_interpolation = (flags & HEREDOC_ALLOWS_INTERPOLATION) != 0;
+    heredoc->started = (flags & HEREDOC_STARTED) != 0;
+    heredoc->end_valid = (flags & HEREDOC_END_VALID) != 0;
+    heredoc->escapes = 0;
+    if (flags & HEREDOC_HAS_ESCAPES) {
+      if (position >= length) break;
+      heredoc->escapes = (uint8_t)buffer[position++];
+    }
+    heredoc->offset = state->chars_used;
+    if (!read_utf8_string(state, buffer, length, &position, &heredoc->word_length) ||
+        !read_utf8_string(state, buffer, length, &position, &heredoc->indent_length)) {
+      break;
+    }
+    state->heredoc_count++;
+  }
+
+  if (state->heredoc_count != heredoc_count || position != length) {
+    // Invalid data, so start over with the initial state
+    state->heredoc_count = 0;
+    state->chars_used = 0;
+    return;
+  }
+
+  state->inside_interpolation_variable = (header & STATE_INSIDE_INTERPOLATION_VARIABLE) != 0;
+  state->check_selbrace = (header & STATE_CHECK_SELBRACE) != 0;
 }
 
-bool tree_sitter_puppet_external_scanner_scan(void *payload, TSLexer *lexer, const bool *valid_symbols) {
+static bool scan(void *payload, TSLexer *lexer, const bool *valid_symbols) {
   ScannerState *state = (ScannerState*)payload;
+  bool indent_skipped = false;
 
   if (valid_symbols[HEREDOC_BODY_START]) {
-    if (state->open_heredocs.size > 0 &&
-        !state->open_heredocs.contents[0].started) {
+    if (state->heredoc_count > 0 &&
+        !state->heredocs[0].started) {
       if (scan_heredoc_body_start(lexer, state)) {
         return true;
       }
     }
   }
 
-  if (state->open_heredocs.size > 0) {
-    Heredoc *heredoc = array_get(&state->open_heredocs, 0);
+  // During error recovery the parser could accept any token, so the scanner
+  // would try every scan function at every position the parser skips. Only
+  // the body start above is cheap and helps the parser to get back into a
+  // heredoc, everything else is left to the internal lexer.
+  if (is_error_recovery(valid_symbols)) {
+    return false;
+  }
+
+  if (state->heredoc_count > 0) {
+    Heredoc *heredoc = &state->heredocs[0];
     if (heredoc->started &&
         heredoc->end_valid &&
-        heredoc->indent.size > 0) {
-      for(size_t position_in_indent = 0; position_in_indent < heredoc->indent.size; position_in_indent++) {
-        if (lexer->lookahead == *array_get(&heredoc->indent, position_in_indent)) {
-          lexer->advance(lexer, true);
+        heredoc->indent_length > 0) {
+      STATS_HELPER(SCAN_INDENT);
+      const int32_t *indent = heredoc_indent(state, heredoc);
+      for(size_t position_in_indent = 0; position_in_indent < heredoc->indent_length; position_in_indent++) {
+        if (lexer->lookahead == indent[position_in_indent]) {
+          advance(lexer, true);
+          indent_skipped = true;
         }
       }
     }
@@ -922,9 +1678,9 @@ bool tree_sitter_puppet_external_scanner_scan(void *payload, TSLexer *lexer, con
   if (valid_symbols[INTERPOLATION_NOBRACE_VARIABLE] ||
        valid_symbols[INTERPOLATION_BRACE_VARIABLE] ||
        valid_symbols[INTERPOLATION_EXPRESSION]) {
-    if (state->open_heredocs.size == 0 ||
-        (state->open_heredocs.contents[0].started &&
-        state->open_heredocs.contents[0].allows_interpolation)) {
+    if (state->heredoc_count == 0 ||
+        (state->heredocs[0].started &&
+        state->heredocs[0].allows_interpolation)) {
       if (scan_interpolation(lexer, state)) {
         return true;
       }
@@ -944,10 +1700,26 @@ bool tree_sitter_puppet_external_scanner_scan(void *payload, TSLexer *lexer, con
   }
 
   if (valid_symbols[HEREDOC_CONTENT] || valid_symbols[HEREDOC_BODY_END]) {
-    if (state->open_heredocs.size > 0) {
-      return scan_heredoc_content(lexer, state);
+    if (state->heredoc_count > 0) {
+      return scan_heredoc_content(lexer, state, indent_skipped);
     }
   }
 
   return false;
 }
+
+bool tree_sitter_puppet_external_scanner_scan(void *payload, TSLexer *lexer, const bool *valid_symbols) {
+#ifdef TREE_SITTER_PUPPET_STATS
+  stats_count_valid_symbols(valid_symbols);
+
+  bool found = scan(payload, lexer, valid_symbols);
+  if (found) {
+    stats.scan_returns[lexer->result_symbol]++;
+  } else {
+    stats.scan_failures++;
+  }
+  return found;
+#else
+  return scan(payload, lexer, valid_symbols);
+#endif
+}
@@ -0,0 +1,602 @@
+$x = @(END)
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | EN
+  | END
@@ -0,0 +1,2 @@
+@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)@(a/)
+\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n
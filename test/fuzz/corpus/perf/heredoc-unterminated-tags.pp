@@ -0,0 +1 @@
+@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)@(a)
@@ -0,0 +1 @@
+$x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? $x                                                                                                                                                                                                         ? 
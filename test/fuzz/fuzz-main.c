@@ -0,0 +1,132 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Standalone driver for the fuzz targets
+ *
+ * Usage: <target> path ...
+ *
+ * Runs the fuzz target once for every file or every file in a directory
+ * without libFuzzer. This is used to check the regression corpus with any
+ * compiler. A finding aborts the program.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+
+static int run_file(const char *path) {
+  FILE *file = fopen(path, "rb");
+  uint8_t *data;
+  long size;
+
+  if (!file) {
+    fprintf(stderr, "%s: can't read file\n", path);
+    return 1;
+  }
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  data = malloc(size > 0 ? (size_t)size : 1);
+  if (size < 0 || fread(data, 1, (size_t)size, file) != (size_t)size) {
+    fprintf(stderr, "%s: can't read file\n", path);
+    fclose(file);
+    free(data);
+    return 1;
+  }
+  fclose(file);
+
+  fprintf(stderr, "%s\n", path);
+  LLVMFuzzerTestOneInput(data, (size_t)size);
+  free(data);
+  return 0;
+}
+
+static int compare_names(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static int run_path(const char *path) {
+  struct stat st;
+  int failures = 0;
+
+  if (stat(path, &st) != 0) {
+    fprintf(stderr, "%s: no such file or directory\n", path);
+    return 1;
+  }
+  if (!S_ISDIR(st.st_mode)) return run_file(path);
+
+  DIR *dir = opendir(path);
+  char **names = NULL;
+  size_t count = 0;
+
+  if (!dir) {
+    fprintf(stderr, "%s: can't read directory\n", path);
+    return 1;
+  }
+  for (struct dirent *entry; (entry = readdir(dir)) != NULL;) {
+    if (entry->d_name[0] == '.') continue;
+
+    char *name = malloc(strlen(path) + strlen(entry->d_name) + 2);
+    sprintf(name, "%s/%s", path, entry->d_name);
+    names = realloc(names, (count + 1) * sizeof(char *));
+    names[count++] = name;
+  }
+  closedir(dir);
+
+  qsort(names, count, sizeof(char *), compare_names);
+  for (size_t i = 0; i < count; i++) {
+    failures += run_path(names[i]);
+    free(names[i]);
+  }
+  free(names);
+  return failures;
+}
+
+int main(int argc, char **argv) {
+  int failures = 0;
+
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s path ...\n", argv[0]);
+    return 2;
+  }
+  for (int i = 1; i < argc; i++) {
+    failures += run_path(argv[i]);
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,99 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Parser complexity fuzz target
+ *
+ * Parses the input with tree_sitter_puppet() and measures the time of the
+ * parse. An input is a finding if the parse takes longer than
+ * PUPPET_FUZZ_NS_PER_BYTE nanoseconds per input byte (default: 20000) on
+ * top of PUPPET_FUZZ_NS_BASE nanoseconds (default: 10000000). That is about
+ * a hundred times the usual parse time, so only super-linear work in the
+ * parser or the scanner exceeds it. A slow parse is repeated before it is
+ * reported, so a single delay of the process is not a finding.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+#define PARSE_ATTEMPTS 3
+
+
+static uint64_t env_value(const char *name, uint64_t value) {
+  const char *text = getenv(name);
+
+  return (text && *text) ? strtoull(text, NULL, 10) : value;
+}
+
+static uint64_t parse_time(TSParser *parser, const uint8_t *data, size_t size) {
+  struct timespec start, end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  TSTree *tree = ts_parser_parse_string(parser, NULL, (const char *)data, (uint32_t)size);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  ts_tree_delete(tree);
+
+  return (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000u +
+    (uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  static TSParser *parser;
+  static uint64_t ns_per_byte, ns_base;
+
+  if (!parser) {
+    parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_puppet());
+    ns_per_byte = env_value("PUPPET_FUZZ_NS_PER_BYTE", 20000);
+    ns_base = env_value("PUPPET_FUZZ_NS_BASE", 10000000);
+  }
+  if (size > UINT32_MAX) return 0;
+
+  uint64_t budget = ns_per_byte * size + ns_base;
+  uint64_t ns = parse_time(parser, data, size);
+
+  for (unsigned i = 1; i < PARSE_ATTEMPTS && ns > budget; i++) {
+    uint64_t retry = parse_time(parser, data, size);
+    if (retry < ns) ns = retry;
+  }
+  if (ns > budget) {
+    fprintf(stderr, "slow input: %zu bytes, parse took %llu us (%.1f ns per byte)\n",
+            size, (unsigned long long)(ns / 1000), size ? (double)ns / (double)size : 0.0);
+    abort();
+  }
+  return 0;
+}
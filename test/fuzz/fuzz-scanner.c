@@ -0,0 +1,247 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Scanner complexity fuzz target
+ *
+ * Runs the external scanner over the input like the parser would and
+ * counts the characters the scanner reads. The parser is replaced by a
+ * small model that knows where strings, interpolations and heredocs start
+ * and end and calls the scanner with the valid symbols of that context.
+ * Characters that the scanner doesn't take are consumed like the internal
+ * lexer would.
+ *
+ * An input is a finding if the scanner reads more than
+ * PUPPET_FUZZ_CHARS_PER_BYTE characters per input byte (default: 256) on
+ * top of PUPPET_FUZZ_CHARS_BASE characters (default: 4096). The count does
+ * not depend on timing, so findings can be reproduced anywhere. The worst
+ * known input is a line of "@(" where every heredoc tag reads up to
+ * MAX_HEREDOC_WORD_LENGTH characters, which is about 128 per byte.
+ */
+
+#include <stdio.h>
+
+#include "scanner.c"
+#include "mock-lexer.h"
+
+#define MAX_CONTEXTS 64
+
+#define BIT(token) (1u << (token))
+
+enum Context { CODE, INTERPOLATION, DQ, SQ, HEREDOC, VARIABLE };
+
+static const uint32_t CONTEXT_SYMBOLS[] = {
+  [CODE]          = BIT(QMARK) | BIT(HEREDOC_BODY_START),
+  [INTERPOLATION] = BIT(QMARK) | BIT(HEREDOC_BODY_START),
+  [DQ]            = BIT(DQ_STRING) | BIT(DQ_ESCAPE_SEQUENCE) |
+                    BIT(INTERPOLATION_NOBRACE_VARIABLE) |
+                    BIT(INTERPOLATION_BRACE_VARIABLE) |
+                    BIT(INTERPOLATION_EXPRESSION) | BIT(HEREDOC_BODY_START),
+  [SQ]            = BIT(SQ_STRING) | BIT(SQ_ESCAPE_SEQUENCE) | BIT(HEREDOC_BODY_START),
+  [HEREDOC]       = BIT(HEREDOC_CONTENT) | BIT(HEREDOC_BODY_END) |
+                    BIT(HEREDOC_ESCAPE_SEQUENCE) |
+                    BIT(INTERPOLATION_NOBRACE_VARIABLE) |
+                    BIT(INTERPOLATION_BRACE_VARIABLE) |
+                    BIT(INTERPOLATION_EXPRESSION) | BIT(HEREDOC_BODY_START),
+  [VARIABLE]      = BIT(INTERPOLATION_NOSIGIL_VARIABLE) | BIT(HEREDOC_BODY_START),
+};
+
+typedef struct {
+  enum Context contexts[MAX_CONTEXTS];
+  unsigned     depth;
+  uint32_t     next_symbols;      // replace the symbols of the context once
+} Model;
+
+
+static uint64_t env_value(const char *name, uint64_t value) {
+  const char *text = getenv(name);
+
+  return (text && *text) ? strtoull(text, NULL, 10) : value;
+}
+
+static void model_push(Model *model, enum Context context) {
+  if (model->depth < MAX_CONTEXTS - 1) model->contexts[++model->depth] = context;
+}
+
+static void model_pop(Model *model) {
+  if (model->depth > 0) model->depth--;
+}
+
+/**
+ * Update the context for a token of the scanner.
+ */
+
+static void model_token(Model *model, TSSymbol symbol) {
+  switch (symbol) {
+  case QMARK:
+    model->next_symbols = BIT(SELBRACE) | BIT(HEREDOC_BODY_START);
+    break;
+  case INTERPOLATION_NOBRACE_VARIABLE:
+    model_push(model, VARIABLE);
+    break;
+  case INTERPOLATION_BRACE_VARIABLE:
+  case INTERPOLATION_EXPRESSION:
+    model_push(model, INTERPOLATION);
+    model->next_symbols = CONTEXT_SYMBOLS[INTERPOLATION] | BIT(INTERPOLATION_NOSIGIL_VARIABLE);
+    break;
+  case INTERPOLATION_NOSIGIL_VARIABLE:
+    if (model->contexts[model->depth] == VARIABLE) model_pop(model);
+    break;
+  case HEREDOC_BODY_START:
+    model_push(model, HEREDOC);
+    break;
+  case HEREDOC_BODY_END:
+    if (model->contexts[model->depth] == HEREDOC) model_pop(model);
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+ * Consume the next character like the internal lexer and update the
+ * context.
+ */
+
+static void model_char(Model *model, MockLexer *mock) {
+  enum Context context = model->contexts[model->depth];
+
+  // The internal lexer skips whitespace and takes a name as one token
+  if (context == CODE || context == INTERPOLATION) {
+    while (mock->position < mock->length - 1 && is_space(mock->text[mock->position])) {
+      mock->position++;
+    }
+    while (mock->position < mock->length - 1 && is_alnum(mock->text[mock->position]) &&
+           is_alnum(mock->text[mock->position + 1])) {
+      mock->position++;
+    }
+  }
+
+  int32_t c = mock->text[mock->position++];
+  int32_t next = (mock->position < mock->length) ? mock->text[mock->position] : 0;
+
+  switch (context) {
+  case CODE:
+  case INTERPOLATION:
+    if (c == U'"') {
+      model_push(model, DQ);
+    } else if (c == U'\'') {
+      model_push(model, SQ);
+    } else if (c == U'@' && next == U'(') {
+      mock->position++;
+      model->next_symbols = BIT(HEREDOC_START) | BIT(HEREDOC_BODY_START);
+    } else if (c == U'{' && context == INTERPOLATION) {
+      model_push(model, INTERPOLATION);
+    } else if (c == U'}' && context == INTERPOLATION) {
+      model_pop(model);
+    } else if (c == U'#') {
+      while (mock->position < mock->length && mock->text[mock->position] != U'\n') {
+        mock->position++;
+      }
+    }
+    break;
+  case DQ:
+    if (c == U'"') model_pop(model);
+    break;
+  case SQ:
+    if (c == U'\'') model_pop(model);
+    break;
+  case VARIABLE:
+    while (mock->position < mock->length && is_variable_name(mock->text[mock->position])) {
+      mock->position++;
+    }
+    model_pop(model);
+    break;
+  case HEREDOC:
+    break;
+  }
+}
+
+/**
+ * Run the scanner over the source and return the number of characters it
+ * has read.
+ */
+
+static uint64_t scan_source(const char *source, size_t size) {
+  void *scanner = tree_sitter_puppet_external_scanner_create();
+  bool valid_symbols[TOKEN_TYPE_COUNT];
+  Model model = { .contexts = { CODE } };
+  MockLexer mock;
+
+  mock_lexer_init(&mock, source, size);
+
+  while (mock.position < mock.length) {
+    uint32_t symbols = model.next_symbols ? model.next_symbols : CONTEXT_SYMBOLS[model.contexts[model.depth]];
+    uint32_t start = mock.position;
+
+    for (unsigned i = 0; i < TOKEN_TYPE_COUNT; i++) {
+      valid_symbols[i] = (symbols & BIT(i)) != 0;
+    }
+    model.next_symbols = 0;
+
+    if (mock_lexer_scan(&mock, scanner, valid_symbols)) {
+      model_token(&model, mock.lexer.result_symbol);
+      if (mock.position > start) continue;
+
+      // The variable name after an empty token is a token of the grammar
+      if (mock.lexer.result_symbol == INTERPOLATION_NOSIGIL_VARIABLE) {
+        while (mock.position < mock.length && is_variable_name(mock.text[mock.position])) {
+          mock.position++;
+        }
+        if (mock.position > start) continue;
+      }
+    }
+    model_char(&model, &mock);
+  }
+
+  uint64_t chars = mock.advances + mock.column_chars;
+
+  mock_lexer_delete(&mock);
+  tree_sitter_puppet_external_scanner_destroy(scanner);
+  return chars;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  static uint64_t chars_per_byte, chars_base;
+
+  if (chars_per_byte == 0) {
+    chars_per_byte = env_value("PUPPET_FUZZ_CHARS_PER_BYTE", 256);
+    chars_base = env_value("PUPPET_FUZZ_CHARS_BASE", 4096);
+  }
+
+  uint64_t chars = scan_source((const char *)data, size);
+
+  if (chars > chars_per_byte * size + chars_base) {
+    fprintf(stderr, "slow input: %zu bytes, scanner read %llu characters (%.1f per byte)\n",
+            size, (unsigned long long)chars, size ? (double)chars / (double)size : 0.0);
+    abort();
+  }
+  return 0;
+}
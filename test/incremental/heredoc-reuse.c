@@ -0,0 +1,303 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Heredoc reuse test
+ *
+ * Applies edits to the heredocs of a manifest: to the tags, the escape
+ * flags, the end tags with their indent and pipe and to the bodies. After
+ * every edit the manifest is parsed incrementally with the edited old tree
+ * and from scratch. The test fails if the trees differ. All edits keep the
+ * manifest valid, since the error recovery of an incremental parse may
+ * legitimately produce a different tree.
+ *
+ * The characters the external scanner reads for the incremental parse are
+ * reported for every edit. An edit inside a body must not invalidate the
+ * other heredocs, which are much larger than the edited body. For those
+ * edits the scanner may read at most twice the edited body (the look-ahead
+ * for the indent and the content) and a small constant. Edits of tags and
+ * end tags change the extent of the bodies, so they have no limit.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+// The characters read for anything but the edited body
+#define REUSE_SLACK 4096
+
+#define MAX_BODIES 8
+
+
+typedef struct {
+  char     *source;
+  uint32_t length;
+  uint32_t capacity;
+  struct {
+    const char *word;
+    uint32_t   start;
+    uint32_t   end;
+  } bodies[MAX_BODIES];
+  unsigned body_count;
+} Manifest;
+
+typedef struct {
+  const char *name;
+  const char *find;               // the text to replace, first occurrence
+  const char *replace;
+  const char *body;               // the end tag of the edited body or NULL
+} Edit;
+
+
+static void manifest_append(Manifest *manifest, const char *text) {
+  size_t length = strlen(text);
+
+  if (manifest->length + length + 1 > manifest->capacity) {
+    manifest->capacity = 2 * (manifest->length + (uint32_t)length + 1);
+    manifest->source = realloc(manifest->source, manifest->capacity);
+  }
+  memcpy(manifest->source + manifest->length, text, length + 1);
+  manifest->length += (uint32_t)length;
+}
+
+/**
+ * Append a heredoc body with the given number of lines and its end tag.
+ */
+
+static void manifest_body(Manifest *manifest, const char *word, const char *indent,
+                          const char *line, unsigned lines) {
+  char text[256];
+
+  manifest->bodies[manifest->body_count].word = word;
+  manifest->bodies[manifest->body_count].start = manifest->length;
+  for (unsigned i = 0; i < lines; i++) {
+    snprintf(text, sizeof(text), "%s%s %u\n", indent, line, i);
+    manifest_append(manifest, text);
+  }
+  snprintf(text, sizeof(text), "%s| %s\n", indent, word);
+  manifest_append(manifest, text);
+  manifest->bodies[manifest->body_count].end = manifest->length;
+  manifest->body_count++;
+}
+
+/**
+ * The manifest has three heredocs on one line with a small first body and
+ * large bodies after it, and another heredoc in a resource.
+ */
+
+static void manifest_init(Manifest *manifest) {
+  memset(manifest, 0, sizeof(Manifest));
+
+  manifest_append(manifest, "class reuse {\n");
+  manifest_append(manifest, "  $list = [@(FIRST), @(\"SECOND\"/L), @(THIRD:json)]\n");
+  manifest_body(manifest, "FIRST", "    ", "first line", 2);
+  manifest_body(manifest, "SECOND", "    ", "second line with some text and \\\n    more", 400);
+  manifest_body(manifest, "THIRD", "  ", "\"third\": \"line\",", 800);
+  manifest_append(manifest, "  file { '/tmp/reuse':\n    content => @(\"LAST\"/t),\n");
+  manifest_body(manifest, "LAST", "      ", "last line\\twith ${value} and", 400);
+  manifest_append(manifest, "  }\n}\n");
+}
+
+static uint32_t manifest_body_length(const Manifest *manifest, const char *word) {
+  for (unsigned i = 0; i < manifest->body_count; i++) {
+    if (strcmp(manifest->bodies[i].word, word) == 0) {
+      return manifest->bodies[i].end - manifest->bodies[i].start;
+    }
+  }
+  return 0;
+}
+
+static TSPoint point_at(const char *source, uint32_t offset) {
+  TSPoint point = { 0, 0 };
+
+  for (uint32_t i = 0; i < offset; i++) {
+    if (source[i] == '\n') {
+      point.row++;
+      point.column = 0;
+    } else {
+      point.column++;
+    }
+  }
+  return point;
+}
+
+/**
+ * Compare two trees node by node: the symbols, the byte ranges and the
+ * number of children must be the same.
+ */
+
+static bool trees_equal(TSTree *expected, TSTree *actual) {
+  TSTreeCursor a = ts_tree_cursor_new(ts_tree_root_node(expected));
+  TSTreeCursor b = ts_tree_cursor_new(ts_tree_root_node(actual));
+  bool equal = true;
+
+  for (;;) {
+    TSNode x = ts_tree_cursor_current_node(&a), y = ts_tree_cursor_current_node(&b);
+
+    if (ts_node_symbol(x) != ts_node_symbol(y) ||
+        ts_node_start_byte(x) != ts_node_start_byte(y) ||
+        ts_node_end_byte(x) != ts_node_end_byte(y) ||
+        ts_node_child_count(x) != ts_node_child_count(y) ||
+        ts_node_is_missing(x) != ts_node_is_missing(y)) {
+      equal = false;
+      break;
+    }
+
+    if (ts_tree_cursor_goto_first_child(&a)) {
+      ts_tree_cursor_goto_first_child(&b);
+      continue;
+    }
+    while (!ts_tree_cursor_goto_next_sibling(&a)) {
+      if (!ts_tree_cursor_goto_parent(&a)) goto done;
+      ts_tree_cursor_goto_parent(&b);
+    }
+    ts_tree_cursor_goto_next_sibling(&b);
+  }
+
+ done:
+  ts_tree_cursor_delete(&a);
+  ts_tree_cursor_delete(&b);
+  return equal;
+}
+
+/**
+ * Apply the edit to the manifest and its tree, parse incrementally and from
+ * scratch and compare the trees.
+ */
+
+static bool run_edit(TSParser *parser, const Manifest *manifest, TSTree *tree, const Edit *edit) {
+  const char *found = strstr(manifest->source, edit->find);
+
+  if (!found) {
+    printf("FAIL %s: '%s' not found\n", edit->name, edit->find);
+    return false;
+  }
+
+  uint32_t start = (uint32_t)(found - manifest->source);
+  uint32_t old_length = (uint32_t)strlen(edit->find);
+  uint32_t new_length = (uint32_t)strlen(edit->replace);
+  uint32_t length = manifest->length - old_length + new_length;
+  char *source = malloc(length + 1);
+
+  memcpy(source, manifest->source, start);
+  memcpy(source + start, edit->replace, new_length);
+  memcpy(source + start + new_length, found + old_length,
+         manifest->length - start - old_length + 1);
+
+  TSInputEdit input_edit = {
+    start, start + old_length, start + new_length,
+    point_at(manifest->source, start),
+    point_at(manifest->source, start + old_length),
+    point_at(source, start + new_length),
+  };
+  TSTree *old_tree = ts_tree_copy(tree);
+
+  ts_tree_edit(old_tree, &input_edit);
+  tree_sitter_puppet_scanner_stats_reset();
+
+  TSTree *incremental = ts_parser_parse_string(parser, old_tree, source, length);
+  uint64_t chars = tree_sitter_puppet_scanner_stats_chars();
+  TSTree *scratch = ts_parser_parse_string(parser, NULL, source, length);
+  bool ok = true;
+
+  if (!trees_equal(scratch, incremental)) {
+    printf("FAIL %s: the incremental tree differs from the parse from scratch\n", edit->name);
+    ok = false;
+  } else if (edit->body) {
+    uint64_t limit = 2 * (uint64_t)manifest_body_length(manifest, edit->body) + REUSE_SLACK;
+
+    if (chars > limit) {
+      printf("FAIL %s: scanner read %llu characters, limit %llu\n", edit->name,
+             (unsigned long long)chars, (unsigned long long)limit);
+      ok = false;
+    }
+  }
+  if (ok) {
+    printf("ok   %-24s %8llu characters re-lexed\n", edit->name, (unsigned long long)chars);
+  }
+
+  ts_tree_delete(scratch);
+  ts_tree_delete(incremental);
+  ts_tree_delete(old_tree);
+  free(source);
+  return ok;
+}
+
+int main(void) {
+  static const Edit edits[] = {
+    // Edits inside the bodies
+    { "first body insert",    "first line 0",     "first new line 0",     "FIRST" },
+    { "first body delete",    "first line 1",     "first lin 1",          "FIRST" },
+    { "first body new line",  "first line 1\n",   "first line 1\n\n",     "FIRST" },
+    { "first end indent",     "    | FIRST",      "      | FIRST",        "FIRST" },
+    { "first end pipe",       "    | FIRST",      "    FIRST",            "FIRST" },
+    { "first end trim",       "    | FIRST",      "    |- FIRST",         "FIRST" },
+    { "second body insert",   "more 200",         "more text 200",        "SECOND" },
+    { "second escape",        "and \\\n    more 7", "and\n    more 7",    "SECOND" },
+    { "last body insert",     "with ${value} and 9", "with $value and 9", "LAST" },
+    // Edits of tags and end tags change the bodies
+    { "first tag quotes",     "@(FIRST)",         "@(\"FIRST\")",         NULL },
+    { "second escape flags",  "\"SECOND\"/L",     "\"SECOND\"/n",         NULL },
+    { "second no escapes",    "\"SECOND\"/L",     "\"SECOND\"",           NULL },
+    { "third syntax",         "THIRD:json",       "THIRD",                NULL },
+    { "third end trim",       "  | THIRD",        "  |- THIRD",           NULL },
+    { "last escape flags",    "\"LAST\"/t",       "\"LAST\"/ts",          NULL },
+    { "last no interpolation", "@(\"LAST\"/t)",   "@(LAST/t)",            NULL },
+  };
+  Manifest manifest;
+  int failures = 0;
+
+  manifest_init(&manifest);
+
+  TSParser *parser = ts_parser_new();
+
+  ts_parser_set_language(parser, tree_sitter_puppet());
+
+  TSTree *tree = ts_parser_parse_string(parser, NULL, manifest.source, manifest.length);
+
+  if (ts_node_has_error(ts_tree_root_node(tree))) {
+    printf("FAIL the manifest has syntax errors\n");
+    failures++;
+  }
+
+  for (size_t i = 0; i < sizeof(edits) / sizeof(edits[0]); i++) {
+    if (!run_edit(parser, &manifest, tree, &edits[i])) failures++;
+  }
+
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+  free(manifest.source);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,188 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Regex token test
+ *
+ * Parses manifests with regular expressions and counts the tokens that the
+ * parser shifts for the body of every regex. The tokens are taken from the
+ * parse log, because the body tokens are hidden and the node API doesn't
+ * return them. The test fails if a token between the delimiters is not a
+ * regex body token (a '#' starting a comment, for example) or if the body
+ * tokens don't cover the text between the delimiters of the regex node.
+ * The token counts show whether the lexer returns one token per character
+ * or one token per body.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+
+#define MAX_REGEXES 16
+
+typedef struct {
+  char     symbol[64];              // last lexed token
+  uint32_t size;
+  bool     inside;                  // between the delimiters of a regex
+  bool     invalid;                 // unexpected token inside a regex
+  unsigned count;                   // completed regexes
+  uint32_t tokens[MAX_REGEXES];
+  uint32_t bytes[MAX_REGEXES];
+} Census;
+
+
+/**
+ * Return true if the symbol is a token of the regex body.
+ */
+
+static bool is_body_token(const char *symbol) {
+  return (strcmp(symbol, "_regex_char") == 0 ||
+          strcmp(symbol, "_regex_char_escaped") == 0 ||
+          strcmp(symbol, "_regex_body") == 0 ||
+          strcmp(symbol, "#") == 0);
+}
+
+static void census_log(void *payload, TSLogType log_type, const char *message) {
+  Census *census = payload;
+  const char *value;
+
+  if (log_type != TSLogTypeParse) return;
+
+  if (strncmp(message, "lexed_lookahead sym:", 20) == 0 &&
+      (value = strstr(message, ", size:")) != NULL) {
+    size_t length = (size_t)(value - message - 20);
+
+    if (length >= sizeof(census->symbol)) length = sizeof(census->symbol) - 1;
+    memcpy(census->symbol, message + 20, length);
+    census->symbol[length] = '\0';
+    census->size = (uint32_t)strtoul(value + 7, NULL, 10);
+    return;
+  }
+
+  // Only the shifted tokens count, a token may be lexed again
+  if (strncmp(message, "shift", 5) != 0) return;
+
+  if (strcmp(census->symbol, "/") == 0) {
+    if (census->inside) {
+      census->count++;
+    } else if (census->count < MAX_REGEXES) {
+      census->tokens[census->count] = 0;
+      census->bytes[census->count] = 0;
+    }
+    census->inside = !census->inside;
+  } else if (census->inside && census->count < MAX_REGEXES) {
+    if (!is_body_token(census->symbol)) census->invalid = true;
+    census->tokens[census->count]++;
+    census->bytes[census->count] += census->size;
+  }
+}
+
+/**
+ * Check the regex nodes below the node against the census in the order of
+ * the source. Return the number of failures.
+ */
+
+static int check_regexes(const char *source, TSNode node, const Census *census, unsigned *index) {
+  int failures = 0;
+
+  if (strcmp(ts_node_type(node), "regex") == 0) {
+    uint32_t start = ts_node_start_byte(node), end = ts_node_end_byte(node);
+
+    if (*index >= census->count || census->bytes[*index] != end - start - 2) {
+      printf("FAIL %.*s: body tokens don't cover the pattern\n",
+             (int)(end - start), source + start);
+      failures++;
+    }
+    (*index)++;
+    return failures;
+  }
+
+  for (uint32_t i = 0; i < ts_node_child_count(node); i++) {
+    failures += check_regexes(source, ts_node_child(node, i), census, index);
+  }
+  return failures;
+}
+
+int main(void) {
+  static const char *const manifests[] = {
+    "/^[123]$/\n",
+    "/foo\\/bar/\n",
+    "/\"/\n",
+    "if $size =~ /^([0-9]+(\\.[0-9]+)?)([KMGTPEkmgtpe])/ {\n}\n",
+    "$path =~ /^\\/opt\\/[^\\/]+#\\d*$/\n",
+    "$name =~ //\n",
+    "node /^web\\d+\\.example\\.com$/ {\n}\n",
+    "$x = $y ? { /^a/ => 1, /b$/ => 2, default => 3 }\n",
+    "case $os { /(?i:debian|ubuntu)/: { } default: { } }\n",
+  };
+  TSParser *parser = ts_parser_new();
+  Census census;
+  int failures = 0;
+
+  ts_parser_set_language(parser, tree_sitter_puppet());
+  ts_parser_set_logger(parser, (TSLogger){ &census, census_log });
+
+  for (size_t i = 0; i < sizeof(manifests) / sizeof(manifests[0]); i++) {
+    const char *source = manifests[i];
+    unsigned index = 0, tokens = 0;
+    int errors = 0;
+
+    memset(&census, 0, sizeof(census));
+
+    TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)strlen(source));
+    TSNode root = ts_tree_root_node(tree);
+
+    if (ts_node_has_error(root)) {
+      printf("FAIL %s: syntax error\n", source);
+      errors++;
+    } else if (census.invalid || census.inside) {
+      printf("FAIL %s: unexpected token inside a regex\n", source);
+      errors++;
+    } else {
+      errors = check_regexes(source, root, &census, &index);
+      if (index == 0 || index != census.count) {
+        printf("FAIL %s: %u regex nodes, %u regexes in the parse log\n", source, index, census.count);
+        errors++;
+      }
+    }
+    for (unsigned j = 0; j < census.count && j < MAX_REGEXES; j++) tokens += census.tokens[j];
+    if (errors == 0) printf("ok   manifest %zu: %u regexes, %u body tokens\n", i + 1, census.count, tokens);
+    failures += errors;
+    ts_tree_delete(tree);
+  }
+
+  ts_parser_delete(parser);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,309 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Heredoc look-ahead test
+ *
+ * Tree-sitter reuses a token of the old tree after an edit if the edit is
+ * outside of the characters the scanner read for the token and the state
+ * of the scanner before the token is unchanged. This test runs the scanner
+ * over manifests with several heredocs on one line and checks both for the
+ * heredocs:
+ *
+ * - A heredoc tag doesn't read beyond its line and the token that starts
+ *   a body doesn't read beyond the end tag of that body.
+ * - An edit of the first body, including its indent, doesn't change the
+ *   state of any token outside of the first body.
+ *
+ * So an edit of a body only invalidates the tokens of that body. A body
+ * whose end tag is far away is checked as well: the look-ahead for the
+ * indent must stop after HEREDOC_INDENT_SCAN_LIMIT characters, even if the
+ * lines are long runs of blanks that the end tag check reads.
+ */
+
+#define TREE_SITTER_PUPPET_STATS
+
+#include <stdio.h>
+
+// The statistics provide the token names for the messages
+#include "scanner.c"
+#include "mock-lexer.h"
+
+#define MAX_TOKENS 256
+
+
+typedef struct {
+  int      symbol;
+  uint32_t start;
+  uint32_t end;
+  uint32_t lookahead_end;         // furthest byte offset read
+  unsigned body;                  // the body the token belongs to or 0
+  char     state[TREE_SITTER_SERIALIZATION_BUFFER_SIZE];
+  unsigned state_length;
+} Token;
+
+typedef struct {
+  Token    tokens[MAX_TOKENS];
+  size_t   count;
+} Tokens;
+
+
+static bool scan_token(MockLexer *mock, void *scanner, const bool *valid_symbols,
+                       unsigned body, Tokens *tokens) {
+  uint32_t start = mock->position;
+
+  if (tokens->count == MAX_TOKENS) return false;
+  if (!mock_lexer_scan(mock, scanner, valid_symbols)) return false;
+
+  Token *token = &tokens->tokens[tokens->count++];
+
+  token->symbol = (int)mock->lexer.result_symbol;
+  token->start = mock->offsets[start];
+  token->end = mock->offsets[mock->position];
+  token->lookahead_end = mock->offsets[mock->lookahead_end];
+  token->body = body;
+  token->state_length = mock->state_length;
+  memcpy(token->state, mock->state, mock->state_length);
+  return true;
+}
+
+/**
+ * Scan the heredoc tags on the first line of the source and then all
+ * bodies like the parser does. Return false if the scanner fails.
+ */
+
+static bool scan_heredocs(const char *source, Tokens *tokens) {
+  bool valid_symbols[TOKEN_TYPE_COUNT] = {false};
+  const char *newline = strchr(source, '\n');
+  void *scanner = tree_sitter_puppet_external_scanner_create();
+  MockLexer mock;
+  unsigned bodies = 0;
+  bool ok = false;
+
+  mock_lexer_init(&mock, source, strlen(source));
+  tokens->count = 0;
+
+  valid_symbols[HEREDOC_START] = true;
+  for (const char *tag = strstr(source, "@("); tag && tag < newline; tag = strstr(tag + 2, "@(")) {
+    mock.position = (uint32_t)(tag - source) + 2;
+    if (!scan_token(&mock, scanner, valid_symbols, 0, tokens)) goto done;
+    bodies++;
+  }
+  valid_symbols[HEREDOC_START] = false;
+  mock.position = (uint32_t)(newline - source);
+
+  for (unsigned body = 1; body <= bodies; body++) {
+    valid_symbols[HEREDOC_BODY_START] = true;
+    if (!scan_token(&mock, scanner, valid_symbols, body, tokens)) goto done;
+    valid_symbols[HEREDOC_BODY_START] = false;
+
+    valid_symbols[HEREDOC_CONTENT] = true;
+    valid_symbols[HEREDOC_BODY_END] = true;
+    valid_symbols[HEREDOC_ESCAPE_SEQUENCE] = true;
+    for (;;) {
+      if (!scan_token(&mock, scanner, valid_symbols, body, tokens)) goto done;
+      if (mock.lexer.result_symbol == HEREDOC_BODY_END) break;
+    }
+    valid_symbols[HEREDOC_CONTENT] = false;
+    valid_symbols[HEREDOC_BODY_END] = false;
+    valid_symbols[HEREDOC_ESCAPE_SEQUENCE] = false;
+  }
+  ok = true;
+
+ done:
+  mock_lexer_delete(&mock);
+  tree_sitter_puppet_external_scanner_destroy(scanner);
+  return ok;
+}
+
+/**
+ * Return the byte offset after the end tag of the body that starts at the
+ * offset: the first line that starts with '|' and contains the word.
+ */
+
+static uint32_t body_end(const char *source, uint32_t start, const char *word) {
+  const char *line = source + start;
+
+  while ((line = strchr(line, '\n')) != NULL) {
+    const char *p = ++line, *eol = strchr(line, '\n');
+
+    while (*p == ' ') p++;
+    if (*p == '|' && eol && strstr(p, word) && strstr(p, word) < eol) {
+      return (uint32_t)(eol - source) + 1;
+    }
+  }
+  return (uint32_t)strlen(source);
+}
+
+static bool check_lookahead(const char *name, const char *source, const Tokens *tokens) {
+  static const char *const words[] = { "", "FIRST", "SECOND", "THIRD" };
+  uint32_t line_end = (uint32_t)(strchr(source, '\n') - source);
+  bool ok = true;
+
+  for (size_t i = 0; i < tokens->count; i++) {
+    const Token *token = &tokens->tokens[i];
+    uint32_t limit = (token->body == 0) ? line_end : body_end(source, token->start, words[token->body]);
+
+    if (token->lookahead_end > limit) {
+      printf("FAIL %s: %s at %u reads up to %u, limit %u\n", name,
+             TOKEN_TYPE_NAMES[token->symbol], token->start, token->lookahead_end, limit);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+/**
+ * Compare the tokens that don't belong to the first body. Their positions
+ * move with the edit, but the symbols and states must be the same.
+ */
+
+static bool check_states(const char *name, const Tokens *expected, const Tokens *actual) {
+  size_t i = 0, j = 0;
+
+  for (;;) {
+    while (i < expected->count && expected->tokens[i].body == 1) i++;
+    while (j < actual->count && actual->tokens[j].body == 1) j++;
+    if (i == expected->count || j == actual->count) break;
+
+    const Token *a = &expected->tokens[i++], *b = &actual->tokens[j++];
+
+    if (a->symbol != b->symbol || a->state_length != b->state_length ||
+        memcmp(a->state, b->state, a->state_length) != 0) {
+      printf("FAIL %s: the state after %s at %u changed\n", name,
+             TOKEN_TYPE_NAMES[b->symbol], b->start);
+      return false;
+    }
+  }
+  if (i != expected->count || j != actual->count) {
+    printf("FAIL %s: the number of tokens changed\n", name);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Scan the body start of a heredoc with lines of blanks before the end tag
+ * and check that the look-ahead stays within the limit.
+ */
+
+static bool check_indent_limit(const char *name, const char *line, unsigned lines) {
+  size_t length = strlen(line), size = 16 + lines * length + 16;
+  char *source = malloc(size), *p = source;
+  Tokens *tokens = malloc(sizeof(Tokens));
+  bool ok = true;
+
+  p += sprintf(p, "@(FIRST)\n");
+  for (unsigned i = 0; i < lines; i++, p += length) {
+    memcpy(p, line, length);
+  }
+  sprintf(p, "  | FIRST\n");
+
+  if (!scan_heredocs(source, tokens)) {
+    printf("FAIL %s: scanner failed\n", name);
+    ok = false;
+  } else {
+    // The tag and the body start are the first tokens
+    const Token *token = &tokens->tokens[1];
+    uint32_t limit = token->start + HEREDOC_INDENT_SCAN_LIMIT + 2;
+
+    if (token->lookahead_end > limit) {
+      printf("FAIL %s: %s at %u reads up to %u, limit %u\n", name,
+             TOKEN_TYPE_NAMES[token->symbol], token->start, token->lookahead_end, limit);
+      ok = false;
+    } else {
+      printf("ok   %s: reads %u characters\n", name, token->lookahead_end - token->start);
+    }
+  }
+
+  free(tokens);
+  free(source);
+  return ok;
+}
+
+int main(void) {
+  static const char *const tags[] = {
+    "$list = [@(FIRST), @(\"SECOND\"/L), @(THIRD:json)]\n",
+    "notice(@(FIRST/t), @(SECOND), @(\"THIRD\"))\n",
+  };
+  static const char *const first_bodies[] = {
+    "  first line\n  | FIRST\n",
+    "  first line with more text\n  | FIRST\n",
+    "  first line\n  another line\n\n  | FIRST\n",
+    "      first line\n      | FIRST\n",
+    "first line\n| FIRST\n",
+    "  first \\t line\n  |- FIRST\n",
+  };
+  static const char *const rest =
+    "    second line \\\n    second line\n    | SECOND\n"
+    "  {\n    \"third\": 1\n  }\n  |- THIRD\n"
+    "notice($list)\n";
+  int failures = 0;
+
+  for (size_t t = 0; t < sizeof(tags) / sizeof(tags[0]); t++) {
+    Tokens *expected = malloc(sizeof(Tokens)), *actual = malloc(sizeof(Tokens));
+    char source[1024], name[32];
+
+    for (size_t b = 0; b < sizeof(first_bodies) / sizeof(first_bodies[0]); b++) {
+      Tokens *tokens = (b == 0) ? expected : actual;
+
+      snprintf(source, sizeof(source), "%s%s%s", tags[t], first_bodies[b], rest);
+      snprintf(name, sizeof(name), "tags %zu body %zu", t + 1, b + 1);
+
+      if (!scan_heredocs(source, tokens)) {
+        printf("FAIL %s: scanner failed\n", name);
+        failures++;
+        continue;
+      }
+      if (!check_lookahead(name, source, tokens) ||
+          (b > 0 && !check_states(name, expected, tokens))) {
+        failures++;
+        continue;
+      }
+      printf("ok   %s: %zu tokens\n", name, tokens->count);
+    }
+
+    free(expected);
+    free(actual);
+  }
+
+  // Lines of 1000 blanks, so the end tag check reads a whole line at once
+  char blanks[1002];
+
+  memset(blanks, ' ', 1000);
+  strcpy(blanks + 1000, "\n");
+  if (!check_indent_limit("indent limit blanks", blanks, 200)) failures++;
+
+  blanks[0] = '|';
+  if (!check_indent_limit("indent limit bars", blanks, 200)) failures++;
+  if (!check_indent_limit("indent limit short lines", "  x\n", 50000)) failures++;
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,320 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Heredoc token test
+ *
+ * Runs the external scanner over heredocs with a growing number of plain
+ * lines and checks that the body is always returned as the same number of
+ * tokens. The number of content tokens must not depend on the length of
+ * the heredoc. Lines with escape sequences or interpolations in a heredoc
+ * that allows them are split by those tokens, so every line adds the same
+ * number of tokens there.
+ *
+ * The content must still stop at every escape sequence and interpolation.
+ * For a few bodies with '\t' and '\n' escapes and '$' and '${...}'
+ * interpolations the test compares the tokens with the expected symbols
+ * and text.
+ */
+
+#include <stdio.h>
+
+#include "scanner.c"
+#include "mock-lexer.h"
+
+
+/**
+ * Scan the heredoc in the source and return the number of tokens from the
+ * body start to the body end or -1 if the scanner fails.
+ */
+
+static long count_heredoc_tokens(const char *source) {
+  bool valid_symbols[TOKEN_TYPE_COUNT] = {false};
+  const char *tag = strstr(source, "@(");
+  void *scanner = tree_sitter_puppet_external_scanner_create();
+  MockLexer mock;
+  long count = -1;
+
+  mock_lexer_init(&mock, source, strlen(source));
+  mock.position = (uint32_t)(tag - source) + 2;
+
+  valid_symbols[HEREDOC_START] = true;
+  if (!mock_lexer_scan(&mock, scanner, valid_symbols)) goto done;
+  valid_symbols[HEREDOC_START] = false;
+
+  // The closing parenthesis is a token of the grammar
+  if (mock.text[mock.position] != U')') goto done;
+  mock.position++;
+
+  valid_symbols[HEREDOC_BODY_START] = true;
+  if (!mock_lexer_scan(&mock, scanner, valid_symbols)) goto done;
+  valid_symbols[HEREDOC_BODY_START] = false;
+
+  valid_symbols[HEREDOC_CONTENT] = true;
+  valid_symbols[HEREDOC_BODY_END] = true;
+  valid_symbols[HEREDOC_ESCAPE_SEQUENCE] = true;
+  valid_symbols[INTERPOLATION_NOBRACE_VARIABLE] = true;
+  valid_symbols[INTERPOLATION_BRACE_VARIABLE] = true;
+  valid_symbols[INTERPOLATION_EXPRESSION] = true;
+
+  for (long tokens = 1;; tokens++) {
+    if (!mock_lexer_scan(&mock, scanner, valid_symbols)) break;
+    if (mock.lexer.result_symbol == HEREDOC_BODY_END) {
+      count = tokens;
+      break;
+    }
+  }
+
+ done:
+  mock_lexer_delete(&mock);
+  tree_sitter_puppet_external_scanner_destroy(scanner);
+  return count;
+}
+
+/**
+ * A token that the scanner is expected to return. The list of tokens ends
+ * with a NULL text.
+ */
+
+typedef struct {
+  int        symbol;
+  const char *text;
+} ExpectedToken;
+
+typedef struct {
+  const char    *source;
+  ExpectedToken tokens[16];
+} BoundaryCase;
+
+/**
+ * Skip over an interpolation like the parser does: the variable name after
+ * a '$' or '${' is a token of the grammar that follows a zero-width token
+ * of the scanner and an expression ends with the next '}'.
+ */
+
+static bool skip_interpolation(MockLexer *mock, void *scanner, int symbol) {
+  if (symbol == INTERPOLATION_EXPRESSION) {
+    while (mock->position < mock->length && mock->text[mock->position] != U'}') mock->position++;
+    mock->position++;
+    return true;
+  }
+
+  bool valid_symbols[TOKEN_TYPE_COUNT] = {false};
+
+  valid_symbols[INTERPOLATION_NOSIGIL_VARIABLE] = true;
+  if (!mock_lexer_scan(mock, scanner, valid_symbols)) return false;
+  while (mock->position < mock->length && is_variable_name(mock->text[mock->position])) {
+    mock->position++;
+  }
+  if (symbol == INTERPOLATION_BRACE_VARIABLE) mock->position++;
+  return true;
+}
+
+/**
+ * Scan the heredoc of the case and compare the tokens from the body start
+ * to the body end with the expected tokens.
+ */
+
+static bool check_boundaries(const BoundaryCase *test) {
+  bool valid_symbols[TOKEN_TYPE_COUNT] = {false};
+  const char *source = test->source;
+  void *scanner = tree_sitter_puppet_external_scanner_create();
+  MockLexer mock;
+  bool ok = false;
+
+  mock_lexer_init(&mock, source, strlen(source));
+  mock.position = (uint32_t)(strstr(source, "@(") - source) + 2;
+
+  valid_symbols[HEREDOC_START] = true;
+  if (!mock_lexer_scan(&mock, scanner, valid_symbols)) goto done;
+  valid_symbols[HEREDOC_START] = false;
+  mock.position++;
+
+  valid_symbols[HEREDOC_BODY_START] = true;
+  if (!mock_lexer_scan(&mock, scanner, valid_symbols)) goto done;
+  valid_symbols[HEREDOC_BODY_START] = false;
+
+  valid_symbols[HEREDOC_CONTENT] = true;
+  valid_symbols[HEREDOC_BODY_END] = true;
+  valid_symbols[HEREDOC_ESCAPE_SEQUENCE] = true;
+  valid_symbols[INTERPOLATION_NOBRACE_VARIABLE] = true;
+  valid_symbols[INTERPOLATION_BRACE_VARIABLE] = true;
+  valid_symbols[INTERPOLATION_EXPRESSION] = true;
+
+  for (const ExpectedToken *expected = test->tokens; expected->text; expected++) {
+    uint32_t start;
+
+    if (!mock_lexer_scan(&mock, scanner, valid_symbols)) {
+      printf("FAIL %s: no token, expected '%s'\n", source, expected->text);
+      goto done;
+    }
+    start = mock.offsets[mock.token_start];
+
+    int symbol = (int)mock.lexer.result_symbol;
+    uint32_t length = mock.offsets[mock.position] - start;
+
+    if (symbol != expected->symbol || length != strlen(expected->text) ||
+        memcmp(source + start, expected->text, length) != 0) {
+      printf("FAIL %s: token %d '%.*s' at %u, expected %d '%s'\n", source,
+             symbol, (int)length, source + start, start, expected->symbol, expected->text);
+      goto done;
+    }
+
+    if (symbol == INTERPOLATION_NOBRACE_VARIABLE || symbol == INTERPOLATION_BRACE_VARIABLE ||
+        symbol == INTERPOLATION_EXPRESSION) {
+      if (!skip_interpolation(&mock, scanner, symbol)) goto done;
+    }
+  }
+
+  if (mock.lexer.result_symbol != HEREDOC_BODY_END) {
+    printf("FAIL %s: the body doesn't end with the last token\n", source);
+    goto done;
+  }
+  ok = true;
+
+ done:
+  mock_lexer_delete(&mock);
+  tree_sitter_puppet_external_scanner_destroy(scanner);
+  return ok;
+}
+
+/**
+ * Build a manifest with a heredoc of the given number of lines.
+ */
+
+static char *heredoc_manifest(const char *tag, const char *line, long lines) {
+  size_t size = strlen(tag) + 64 + lines * (strlen(line) + 1);
+  char *source = malloc(size);
+  char *p = source;
+
+  p += sprintf(p, "$text = @(%s)\n", tag);
+  for (long i = 0; i < lines; i++) {
+    p += sprintf(p, "%s\n", line);
+  }
+  sprintf(p, "  | END\nnotice($text)\n");
+
+  return source;
+}
+
+int main(void) {
+  static const BoundaryCase boundaries[] = {
+    // Escapes split the content, other backslashes are content
+    { "$a = @(END/tn)\n  one\\ttwo\\n\n  three \\s four\n  | END\n", {
+        { HEREDOC_CONTENT, "one" },
+        { HEREDOC_ESCAPE_SEQUENCE, "\\t" },
+        { HEREDOC_CONTENT, "two" },
+        { HEREDOC_ESCAPE_SEQUENCE, "\\n" },
+        { HEREDOC_CONTENT, "\n  three " },
+        { HEREDOC_CONTENT, "\\s" },
+        { HEREDOC_CONTENT, " four\n" },
+        { HEREDOC_BODY_END, "| END" },
+        { 0, NULL } } },
+    // Interpolations split the content, a '$' without a name is content
+    { "$a = @(\"END\")\n  one ${x} two\n  $y three ${f(1)}\n  $ four\n  | END\n", {
+        { HEREDOC_CONTENT, "one " },
+        { INTERPOLATION_BRACE_VARIABLE, "${" },
+        { HEREDOC_CONTENT, " two\n" },
+        { INTERPOLATION_NOBRACE_VARIABLE, "$" },
+        { HEREDOC_CONTENT, " three " },
+        { INTERPOLATION_EXPRESSION, "${" },
+        { HEREDOC_CONTENT, "\n" },
+        { HEREDOC_CONTENT, "$" },
+        { HEREDOC_CONTENT, " four\n" },
+        { HEREDOC_BODY_END, "| END" },
+        { 0, NULL } } },
+    // Escapes and interpolations next to each other
+    { "$a = @(\"END\"/tn)\n  a\\t${x}\\n\n  $y\\t\n  | END\n", {
+        { HEREDOC_CONTENT, "a" },
+        { HEREDOC_ESCAPE_SEQUENCE, "\\t" },
+        { INTERPOLATION_BRACE_VARIABLE, "${" },
+        { HEREDOC_ESCAPE_SEQUENCE, "\\n" },
+        { HEREDOC_CONTENT, "\n" },
+        { INTERPOLATION_NOBRACE_VARIABLE, "$" },
+        { HEREDOC_ESCAPE_SEQUENCE, "\\t" },
+        { HEREDOC_CONTENT, "\n" },
+        { HEREDOC_BODY_END, "| END" },
+        { 0, NULL } } },
+    // Without escapes and interpolation the whole body is one token
+    { "$a = @(END)\n  one\\ttwo ${x}\n  $y\n  | END\n", {
+        { HEREDOC_CONTENT, "one\\ttwo ${x}\n  $y\n" },
+        { HEREDOC_BODY_END, "| END" },
+        { 0, NULL } } },
+  };
+  static const char *const lines[] = {
+    "    plain text",
+    "    text with $dollar and \\backslash",
+    "    END is not the end tag",
+    "",
+  };
+  static const char *const tags[] = { "END", "END/", "\"END\"" };
+  int failures = 0;
+
+  for (size_t t = 0; t < sizeof(tags) / sizeof(tags[0]); t++) {
+    for (size_t l = 0; l < sizeof(lines) / sizeof(lines[0]); l++) {
+      long first = -1, per_line = 0;
+
+      for (long n = 1; n <= 10000; n *= 10) {
+        char *source = heredoc_manifest(tags[t], lines[l], n);
+        long count = count_heredoc_tokens(source);
+
+        // Lines with an escape or interpolation are split by those tokens,
+        // so every line adds the same number of tokens
+        if (n == 1) {
+          char *second = heredoc_manifest(tags[t], lines[l], 2);
+
+          first = count;
+          per_line = count_heredoc_tokens(second) - count;
+          free(second);
+        }
+
+        long expected = first + (n - 1) * per_line;
+
+        if (count < 0 || count != expected) {
+          printf("FAIL @(%s) with %ld lines '%s': %ld tokens, expected %ld\n",
+                 tags[t], n, lines[l], count, expected);
+          failures++;
+        }
+        free(source);
+      }
+      printf("ok   @(%s) with '%s': %ld tokens + %ld per line\n", tags[t], lines[l],
+             first, per_line);
+    }
+  }
+
+  for (size_t b = 0; b < sizeof(boundaries) / sizeof(boundaries[0]); b++) {
+    if (!check_boundaries(&boundaries[b])) {
+      failures++;
+    } else {
+      printf("ok   boundaries %zu\n", b + 1);
+    }
+  }
+
+  return failures ? 1 : 0;
+}
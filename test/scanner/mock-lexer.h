@@ -0,0 +1,205 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * A TSLexer implementation over an in-memory string, so the external
+ * scanner can be tested without the tree-sitter library. The tests include
+ * the scanner source, so everything here is static.
+ */
+
+#ifndef PUPPET_MOCK_LEXER_H_
+#define PUPPET_MOCK_LEXER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tree_sitter/parser.h"
+
+
+typedef struct {
+  TSLexer  lexer;                 // must be the first member
+  int32_t  *text;                 // the input as code points
+  uint32_t *offsets;              // byte offset of every code point
+  uint32_t length;
+  uint32_t position;              // current position of the lexer
+  uint32_t token_start;           // start of the token after skipped chars
+  uint32_t token_end;             // position of the last mark_end call
+  uint32_t lookahead_end;         // furthest position read by the last scan
+  bool     marked;
+  bool     skipping;              // no character of the token consumed yet
+  uint64_t advances;              // total number of advance calls
+  uint64_t column_chars;          // characters walked by get_column
+  char     state[TREE_SITTER_SERIALIZATION_BUFFER_SIZE];
+  unsigned state_length;          // scanner state after the last token
+} MockLexer;
+
+
+static void mock_advance(TSLexer *lexer, bool skip) {
+  MockLexer *mock = (MockLexer *)lexer;
+
+  mock->advances++;
+  if (mock->position < mock->length) mock->position++;
+  if (mock->position > mock->lookahead_end) mock->lookahead_end = mock->position;
+  if (skip && mock->skipping) mock->token_start = mock->position;
+  if (!skip) mock->skipping = false;
+
+  lexer->lookahead = (mock->position < mock->length) ? mock->text[mock->position] : 0;
+}
+
+static void mock_mark_end(TSLexer *lexer) {
+  MockLexer *mock = (MockLexer *)lexer;
+
+  mock->token_end = mock->position;
+  mock->marked = true;
+}
+
+/**
+ * Walk back to the start of the line like the tree-sitter lexer does.
+ */
+
+static uint32_t mock_get_column(TSLexer *lexer) {
+  MockLexer *mock = (MockLexer *)lexer;
+  uint32_t start = mock->position;
+
+  while (start > 0 && mock->text[start - 1] != U'\n') {
+    start--;
+    mock->column_chars++;
+  }
+  return mock->position - start;
+}
+
+static bool mock_is_at_included_range_start(const TSLexer *lexer) {
+  (void)lexer;
+  return false;
+}
+
+static bool mock_eof(const TSLexer *lexer) {
+  const MockLexer *mock = (const MockLexer *)lexer;
+
+  return mock->position >= mock->length;
+}
+
+/**
+ * Initialize the lexer with the UTF-8 source. Invalid sequences are taken
+ * byte by byte.
+ */
+
+static void mock_lexer_init(MockLexer *mock, const char *source, size_t size) {
+  const uint8_t *p = (const uint8_t *)source, *end = p + size;
+
+  memset(mock, 0, sizeof(MockLexer));
+  mock->text = malloc((size + 1) * sizeof(int32_t));
+  mock->offsets = malloc((size + 1) * sizeof(uint32_t));
+
+  while (p < end) {
+    int32_t c = *p++;
+
+    mock->offsets[mock->length] = (uint32_t)(p - 1 - (const uint8_t *)source);
+    int count = (c >= 0xf0) ? 3 : (c >= 0xe0) ? 2 : (c >= 0xc0) ? 1 : 0;
+
+    if (count > end - p) count = 0;
+    if (count > 0) c &= (0x3f >> count);
+    for (; count > 0; count--) {
+      c = (c << 6) | (*p++ & 0x3f);
+    }
+    mock->text[mock->length++] = c;
+  }
+  mock->offsets[mock->length] = (uint32_t)size;
+
+  mock->lexer.advance = mock_advance;
+  mock->lexer.mark_end = mock_mark_end;
+  mock->lexer.get_column = mock_get_column;
+  mock->lexer.is_at_included_range_start = mock_is_at_included_range_start;
+  mock->lexer.eof = mock_eof;
+}
+
+static void mock_lexer_delete(MockLexer *mock) {
+  free(mock->text);
+  free(mock->offsets);
+  mock->text = NULL;
+  mock->offsets = NULL;
+}
+
+/**
+ * Move the lexer to the code point starting at the byte offset. Return
+ * false if no code point starts there.
+ */
+
+static inline bool mock_lexer_seek(MockLexer *mock, uint32_t offset) {
+  uint32_t low = 0, high = mock->length;
+
+  while (low < high) {
+    uint32_t middle = low + (high - low) / 2;
+
+    if (mock->offsets[middle] < offset) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  if (mock->offsets[low] != offset) return false;
+  mock->position = low;
+  return true;
+}
+
+/**
+ * Call the external scanner at the current position like the parser does:
+ * restore the state saved after the previous token, scan and save the state
+ * again if a token is found. The position moves to the end of the token.
+ * If no token is found, the position is unchanged.
+ */
+
+static bool mock_lexer_scan(MockLexer *mock, void *payload, const bool *valid_symbols) {
+  uint32_t start = mock->position;
+
+  tree_sitter_puppet_external_scanner_deserialize(payload, mock->state, mock->state_length);
+
+  mock->token_start = start;
+  mock->lookahead_end = start;
+  mock->marked = false;
+  mock->skipping = true;
+  mock->lexer.lookahead = (start < mock->length) ? mock->text[start] : 0;
+  mock->lexer.result_symbol = 0;
+
+  if (!tree_sitter_puppet_external_scanner_scan(payload, &mock->lexer, valid_symbols)) {
+    mock->position = start;
+    return false;
+  }
+
+  if (!mock->marked) mock->token_end = mock->position;
+  mock->position = mock->token_end;
+  mock->state_length = tree_sitter_puppet_external_scanner_serialize(payload, mock->state);
+  return true;
+}
+
+#endif // PUPPET_MOCK_LEXER_H_
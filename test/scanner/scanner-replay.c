@@ -0,0 +1,223 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Scanner replay
+ *
+ * Replays the external scanner calls that have been recorded from a parse
+ * and checks that the scanner returns the same tokens. Every manifest
+ * name.pp has its trace in name.trace with one call per line:
+ *
+ *   <start> <valid symbols> <token> <end>
+ *
+ * The start and end are byte offsets into the manifest, the valid symbols
+ * are a hex bitmask of the token types and the token is the token type or
+ * '-' if the scanner found no token. The traces are written by puppet-trace
+ * in the bench directory.
+ *
+ * With -n count the calls are repeated count times and the time per call
+ * and per character is reported for every scan_* function. A call counts
+ * for the scan_* function that was entered last and the characters are the
+ * characters the scanner advanced over. The scanner in this file is built
+ * with the statistics, which assign the calls to the scan_* functions and
+ * show that the scanner allocates nothing but its state. The timing runs
+ * use the scanner without the statistics in scanner-timing.c.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define TREE_SITTER_PUPPET_STATS
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "scanner.c"
+#include "mock-lexer.h"
+#include "trace.h"
+
+#ifndef PUPPET_TRACE_DIR
+#define PUPPET_TRACE_DIR "traces"
+#endif
+
+// The calls that don't reach a scan_* function
+#define SCAN_NONE SCAN_HELPER_COUNT
+
+// Defined in scanner-timing.c
+void trace_time(const Trace *trace, size_t count, unsigned helpers, HelperTime *times);
+
+
+/**
+ * Replay all calls of the trace in order and compare the tokens. The state
+ * of the scanner before every call is kept for the timing runs.
+ */
+
+static bool trace_verify(Trace *trace, void *scanner) {
+  MockLexer mock;
+  bool ok = true;
+
+  mock_lexer_init(&mock, trace->source, trace->size);
+
+  for (size_t i = 0; i < trace->count; i++) {
+    TraceCall *call = &trace->calls[i];
+    char state[TREE_SITTER_SERIALIZATION_BUFFER_SIZE];
+    uint32_t state_length = mock.state_length;
+    uint64_t helper_calls[SCAN_HELPER_COUNT], advances = mock.advances;
+
+    if (!mock_lexer_seek(&mock, call->start)) {
+      printf("FAIL %s:%u: offset %u is not the start of a character\n",
+             trace->name, call->line, call->start);
+      ok = false;
+      break;
+    }
+
+    call->position = mock.position;
+    call->state_offset = (uint32_t)trace->states_size;
+    call->state_length = state_length;
+    trace->states = realloc(trace->states, trace->states_size + state_length + 1);
+    memcpy(trace->states + trace->states_size, mock.state, state_length);
+    trace->states_size += state_length;
+    memcpy(state, mock.state, state_length);
+
+    memcpy(helper_calls, stats.helper_calls, sizeof(helper_calls));
+    bool found = replay_call(&mock, scanner, call, state, state_length);
+
+    call->chars = (uint32_t)(mock.advances - advances);
+    call->helper = SCAN_NONE;
+    if (memcmp(helper_calls, stats.helper_calls, sizeof(helper_calls)) != 0) {
+      call->helper = (uint8_t)stats.current;
+    }
+
+    int symbol = found ? mock.lexer.result_symbol : -1;
+    uint32_t end = found ? mock.offsets[mock.position] : call->start;
+
+    if (!found) {
+      // Restore the state after the last token
+      memcpy(mock.state, state, state_length);
+      mock.state_length = state_length;
+    }
+
+    if (symbol != call->symbol || (found && end != call->end)) {
+      printf("FAIL %s:%u: expected %s %d-%u, got %s %d-%u\n", trace->name, call->line,
+             call->symbol >= 0 ? TOKEN_TYPE_NAMES[call->symbol] : "nothing",
+             call->start, call->symbol >= 0 ? call->end : call->start,
+             symbol >= 0 ? TOKEN_TYPE_NAMES[symbol] : "nothing", call->start, end);
+      ok = false;
+      break;
+    }
+  }
+
+  mock_lexer_delete(&mock);
+  return ok;
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "Usage: %s [-n count] [path ...]\n", program);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  HelperTime times[SCAN_NONE + 1] = {{0}};
+  char **names = NULL;
+  size_t count = 0, names_count = 0;
+  int option, failures = 0;
+
+  while ((option = getopt(argc, argv, "n:h")) != -1) {
+    switch (option) {
+    case 'n':
+      if (atoi(optarg) < 1) usage(argv[0]);
+      count = (size_t)atoi(optarg);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind == argc) {
+    if (!add_path(&names, &names_count, PUPPET_TRACE_DIR)) return 1;
+  }
+  for (int i = optind; i < argc; i++) {
+    if (!add_path(&names, &names_count, argv[i])) return 1;
+  }
+  if (names_count == 0) {
+    fprintf(stderr, "%s: no trace files\n", argv[0]);
+    return 1;
+  }
+
+  void *scanner = tree_sitter_puppet_external_scanner_create();
+
+  for (size_t i = 0; i < names_count; i++) {
+    Trace trace;
+
+    if (!trace_load(&trace, names[i])) {
+      failures++;
+    } else if (!trace_verify(&trace, scanner)) {
+      failures++;
+    } else {
+      printf("ok   %s: %zu calls\n", trace.name, trace.count);
+      if (count > 0) trace_time(&trace, count, SCAN_NONE + 1, times);
+    }
+    trace_delete(&trace);
+    free(names[i]);
+  }
+  free(names);
+
+  tree_sitter_puppet_external_scanner_destroy(scanner);
+
+  // The scanner state is the only allocation, scanning must not allocate
+  if (stats.alloc_calls != 1 || stats.free_calls != 1) {
+    printf("FAIL scanner allocated %llu times and freed %llu times\n",
+           (unsigned long long)stats.alloc_calls, (unsigned long long)stats.free_calls);
+    failures++;
+  }
+
+  if (count > 0 && failures == 0) {
+    HelperTime total = {0};
+
+    printf("\n%-36s %12s %12s %10s %10s\n", "function", "calls", "chars", "ns/call", "ns/char");
+    for (unsigned helper = 0; helper <= SCAN_NONE; helper++) {
+      const HelperTime *time = &times[helper];
+
+      if (time->calls == 0) continue;
+      printf("%-36s %12llu %12llu %10.1f %10.2f\n",
+             helper < SCAN_NONE ? SCAN_HELPER_NAMES[helper] : "(none)",
+             (unsigned long long)time->calls, (unsigned long long)time->chars,
+             (double)time->ns / (double)time->calls,
+             time->chars ? (double)time->ns / (double)time->chars : 0.0);
+      total.calls += time->calls;
+      total.chars += time->chars;
+      total.ns += time->ns;
+    }
+    printf("%-36s %12llu %12llu %10.1f %10.2f\n", "total",
+           (unsigned long long)total.calls, (unsigned long long)total.chars,
+           (double)total.ns / (double)total.calls,
+           total.chars ? (double)total.ns / (double)total.chars : 0.0);
+  }
+
+  return failures ? 1 : 0;
+}
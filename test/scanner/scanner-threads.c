@@ -0,0 +1,205 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Concurrent scanner replay
+ *
+ * Usage: scanner-threads [-t threads] [-n rounds] [path ...]
+ *
+ * Replays the scanner traces (default: the traces recorded by the build)
+ * on several threads at the same time. Every thread creates its own
+ * scanners and lexers, like a program with one parser per thread, and
+ * checks that the tokens match the trace in every round. The scanner keeps no mutable
+ * global state, so the threads must not see each other. Configure with
+ * -DPUPPET_TSAN=ON to let ThreadSanitizer check every memory access.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "scanner.c"
+#include "mock-lexer.h"
+#include "trace.h"
+
+#ifndef PUPPET_TRACE_DIR
+#define PUPPET_TRACE_DIR "traces"
+#endif
+
+
+typedef struct {
+  const Trace *traces;
+  size_t      trace_count;
+  int         rounds;
+  unsigned    number;
+  size_t      failures;
+  uint64_t    calls;
+} Worker;
+
+
+/**
+ * Replay the calls of the trace with a new scanner. The trace is only
+ * read, so all threads share it. Return false and print the first
+ * difference if a token doesn't match.
+ */
+
+static bool trace_check(const Trace *trace, unsigned number, uint64_t *calls) {
+  void *scanner = tree_sitter_puppet_external_scanner_create();
+  MockLexer mock;
+  bool ok = true;
+
+  mock_lexer_init(&mock, trace->source, trace->size);
+
+  for (size_t i = 0; i < trace->count && ok; i++) {
+    const TraceCall *call = &trace->calls[i];
+    char state[TREE_SITTER_SERIALIZATION_BUFFER_SIZE];
+    uint32_t state_length = mock.state_length;
+
+    if (!mock_lexer_seek(&mock, call->start)) {
+      printf("FAIL %s:%u: offset %u is not the start of a character\n",
+             trace->name, call->line, call->start);
+      ok = false;
+      break;
+    }
+    memcpy(state, mock.state, state_length);
+
+    bool found = replay_call(&mock, scanner, call, state, state_length);
+    int symbol = found ? mock.lexer.result_symbol : -1;
+    uint32_t end = found ? mock.offsets[mock.position] : call->start;
+
+    if (!found) {
+      memcpy(mock.state, state, state_length);
+      mock.state_length = state_length;
+    }
+    if (symbol != call->symbol || (found && end != call->end)) {
+      printf("FAIL %s:%u: thread %u: expected token %d %u-%u, got token %d %u-%u\n",
+             trace->name, call->line, number, call->symbol, call->start,
+             call->symbol >= 0 ? call->end : call->start, symbol, call->start, end);
+      ok = false;
+    }
+    (*calls)++;
+  }
+
+  mock_lexer_delete(&mock);
+  tree_sitter_puppet_external_scanner_destroy(scanner);
+  return ok;
+}
+
+static void *worker_run(void *payload) {
+  Worker *worker = payload;
+
+  for (int round = 0; round < worker->rounds; round++) {
+    for (size_t i = 0; i < worker->trace_count; i++) {
+      if (!trace_check(&worker->traces[i], worker->number, &worker->calls)) {
+        worker->failures++;
+      }
+    }
+  }
+  return NULL;
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "Usage: %s [-t threads] [-n rounds] [path ...]\n", program);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  char **names = NULL;
+  size_t names_count = 0, failures = 0;
+  uint64_t calls = 0;
+  int threads = 8, rounds = 10;
+  int option;
+
+  while ((option = getopt(argc, argv, "t:n:h")) != -1) {
+    switch (option) {
+    case 't':
+      threads = atoi(optarg);
+      if (threads < 1) usage(argv[0]);
+      break;
+    case 'n':
+      rounds = atoi(optarg);
+      if (rounds < 1) usage(argv[0]);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind == argc) {
+    if (!add_path(&names, &names_count, PUPPET_TRACE_DIR)) return 1;
+  }
+  for (int i = optind; i < argc; i++) {
+    if (!add_path(&names, &names_count, argv[i])) return 1;
+  }
+  if (names_count == 0) {
+    fprintf(stderr, "%s: no trace files\n", argv[0]);
+    return 1;
+  }
+
+  Trace *traces = calloc(names_count, sizeof(Trace));
+
+  for (size_t i = 0; i < names_count; i++) {
+    if (!trace_load(&traces[i], names[i])) failures++;
+  }
+
+  if (failures == 0) {
+    pthread_t *ids = calloc((size_t)threads, sizeof(pthread_t));
+    Worker *workers = calloc((size_t)threads, sizeof(Worker));
+
+    for (int i = 0; i < threads; i++) {
+      workers[i] = (Worker){ traces, names_count, rounds, (unsigned)i, 0, 0 };
+      if (pthread_create(&ids[i], NULL, worker_run, &workers[i]) != 0) {
+        fprintf(stderr, "%s: can't create thread\n", argv[0]);
+        return 1;
+      }
+    }
+    for (int i = 0; i < threads; i++) {
+      pthread_join(ids[i], NULL);
+      failures += workers[i].failures;
+      calls += workers[i].calls;
+    }
+    free(workers);
+    free(ids);
+
+    printf("%s %d threads, %d rounds, %zu traces: %llu calls\n",
+           failures ? "FAIL" : "ok  ", threads, rounds, names_count,
+           (unsigned long long)calls);
+  }
+
+  for (size_t i = 0; i < names_count; i++) {
+    trace_delete(&traces[i]);
+    free(names[i]);
+  }
+  free(traces);
+  free(names);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Scanner timing
+ *
+ * The timing runs of scanner-replay. This file includes the scanner without
+ * the statistics, so the measured times are those of the scanner in the
+ * library. The exported functions of the scanner are renamed to link it
+ * into the same program as the scanner with the statistics; the mock lexer
+ * calls them by the new names.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#define tree_sitter_puppet_external_scanner_create      timing_scanner_create
+#define tree_sitter_puppet_external_scanner_destroy     timing_scanner_destroy
+#define tree_sitter_puppet_external_scanner_serialize   timing_scanner_serialize
+#define tree_sitter_puppet_external_scanner_deserialize timing_scanner_deserialize
+#define tree_sitter_puppet_external_scanner_scan        timing_scanner_scan
+
+#include <time.h>
+
+#define PUPPET_TRACE_REPLAY_ONLY
+
+#include "scanner.c"
+#include "mock-lexer.h"
+#include "trace.h"
+
+void trace_time(const Trace *trace, size_t count, unsigned helpers, HelperTime *times);
+
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Repeat the calls of every scan_* function and add up the time. The calls
+ * have been assigned to the functions by the replay with the statistics.
+ */
+
+void trace_time(const Trace *trace, size_t count, unsigned helpers, HelperTime *times) {
+  void *scanner = tree_sitter_puppet_external_scanner_create();
+  MockLexer mock;
+
+  mock_lexer_init(&mock, trace->source, trace->size);
+
+  for (unsigned helper = 0; helper < helpers; helper++) {
+    uint64_t calls = 0, chars = 0, start = now_ns();
+
+    for (size_t n = 0; n < count; n++) {
+      for (size_t i = 0; i < trace->count; i++) {
+        const TraceCall *call = &trace->calls[i];
+
+        if (call->helper != helper) continue;
+
+        mock.position = call->position;
+        replay_call(&mock, scanner, call, trace->states + call->state_offset,
+                    call->state_length);
+        calls++;
+        chars += call->chars;
+      }
+    }
+
+    times[helper].ns += now_ns() - start;
+    times[helper].calls += calls;
+    times[helper].chars += chars;
+  }
+
+  mock_lexer_delete(&mock);
+  tree_sitter_puppet_external_scanner_destroy(scanner);
+}
@@ -0,0 +1,249 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Loading and replaying of the scanner traces in test/scanner/traces. The
+ * tests include the scanner source and mock-lexer.h before this file, so
+ * everything here is static. With PUPPET_TRACE_REPLAY_ONLY defined only
+ * the types and replay_call() are included.
+ */
+
+#ifndef PUPPET_TRACE_H_
+#define PUPPET_TRACE_H_
+
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+
+typedef struct {
+  uint32_t start;
+  uint32_t end;
+  uint16_t valid_symbols;
+  int16_t  symbol;
+  uint32_t line;
+  // Filled in by the first replay
+  uint32_t position;
+  uint32_t state_offset;
+  uint32_t state_length;
+  uint32_t chars;
+  uint8_t  helper;
+} TraceCall;
+
+typedef struct {
+  char      *name;
+  char      *source;
+  size_t    size;
+  TraceCall *calls;
+  size_t    count;
+  char      *states;
+  size_t    states_size;
+} Trace;
+
+typedef struct {
+  uint64_t calls;
+  uint64_t chars;
+  uint64_t ns;
+} HelperTime;
+
+
+/**
+ * Call the scanner like the parser does. The parser ignores a token that
+ * is empty and leaves the scanner state unchanged, so this counts as no
+ * token.
+ */
+
+static bool replay_call(MockLexer *mock, void *scanner, const TraceCall *call,
+                        const char *state, uint32_t state_length) {
+  bool valid_symbols[TOKEN_TYPE_COUNT];
+
+  for (unsigned i = 0; i < TOKEN_TYPE_COUNT; i++) {
+    valid_symbols[i] = (call->valid_symbols & (1u << i)) != 0;
+  }
+
+  memcpy(mock->state, state, state_length);
+  mock->state_length = state_length;
+
+  if (!mock_lexer_scan(mock, scanner, valid_symbols)) return false;
+
+  if (mock->offsets[mock->position] <= call->start &&
+      mock->state_length == state_length &&
+      memcmp(mock->state, state, state_length) == 0) {
+    return false;
+  }
+  return true;
+}
+
+#ifndef PUPPET_TRACE_REPLAY_ONLY
+
+static char *read_file(const char *path, size_t *size) {
+  FILE *file = fopen(path, "rb");
+  char *buffer = NULL;
+  long length;
+
+  if (!file) return NULL;
+  if (fseek(file, 0, SEEK_END) == 0 && (length = ftell(file)) >= 0 &&
+      fseek(file, 0, SEEK_SET) == 0) {
+    buffer = malloc((size_t)length + 1);
+    if (fread(buffer, 1, (size_t)length, file) != (size_t)length) {
+      free(buffer);
+      buffer = NULL;
+    } else {
+      buffer[length] = '\0';
+      *size = (size_t)length;
+    }
+  }
+  fclose(file);
+  return buffer;
+}
+
+/**
+ * Load the trace and its manifest. Return false and print a message on
+ * stderr if something can't be read.
+ */
+
+static bool trace_load(Trace *trace, const char *path) {
+  size_t length = strlen(path), size;
+  char *text, *line, *next;
+  uint32_t number = 0;
+
+  memset(trace, 0, sizeof(Trace));
+  trace->name = strdup(path);
+
+  if (length < 6 || strcmp(path + length - 6, ".trace") != 0) {
+    fprintf(stderr, "%s: not a trace file\n", path);
+    return false;
+  }
+
+  char *manifest = malloc(length);
+  memcpy(manifest, path, length - 6);
+  strcpy(manifest + length - 6, ".pp");
+  trace->source = read_file(manifest, &trace->size);
+  if (!trace->source) {
+    fprintf(stderr, "%s: can't read manifest\n", manifest);
+    free(manifest);
+    return false;
+  }
+  free(manifest);
+
+  if (!(text = read_file(path, &size))) {
+    fprintf(stderr, "%s: can't read trace\n", path);
+    return false;
+  }
+
+  trace->calls = malloc((size / 8 + 1) * sizeof(TraceCall));
+  for (line = text; line && *line; line = next) {
+    unsigned start, valid_symbols, end;
+    char symbol[16];
+
+    next = strchr(line, '\n');
+    if (next) *next++ = '\0';
+    number++;
+
+    if (*line == '#' || *line == '\0') continue;
+
+    if (sscanf(line, "%u %x %15s %u", &start, &valid_symbols, symbol, &end) != 4 ||
+        valid_symbols >= (1u << TOKEN_TYPE_COUNT) ||
+        (strcmp(symbol, "-") != 0 && atoi(symbol) >= TOKEN_TYPE_COUNT)) {
+      fprintf(stderr, "%s:%u: invalid call\n", path, number);
+      free(text);
+      return false;
+    }
+
+    TraceCall *call = &trace->calls[trace->count++];
+    memset(call, 0, sizeof(TraceCall));
+    call->start = start;
+    call->end = end;
+    call->valid_symbols = (uint16_t)valid_symbols;
+    call->symbol = (int16_t)(strcmp(symbol, "-") ? atoi(symbol) : -1);
+    call->line = number;
+  }
+
+  free(text);
+  return true;
+}
+
+static void trace_delete(Trace *trace) {
+  free(trace->name);
+  free(trace->source);
+  free(trace->calls);
+  free(trace->states);
+}
+
+static int compare_names(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/**
+ * Add the trace file at path or all *.trace files in the directory at path
+ * to the list of names.
+ */
+
+static bool add_path(char ***names, size_t *count, const char *path) {
+  struct stat st;
+
+  if (stat(path, &st) != 0) {
+    fprintf(stderr, "%s: no such file or directory\n", path);
+    return false;
+  }
+
+  if (!S_ISDIR(st.st_mode)) {
+    *names = realloc(*names, (*count + 1) * sizeof(char *));
+    (*names)[(*count)++] = strdup(path);
+    return true;
+  }
+
+  DIR *dir = opendir(path);
+  size_t first = *count;
+
+  if (!dir) {
+    fprintf(stderr, "%s: can't read directory\n", path);
+    return false;
+  }
+  for (struct dirent *entry; (entry = readdir(dir)) != NULL;) {
+    size_t length = strlen(entry->d_name);
+
+    if (length > 6 && strcmp(entry->d_name + length - 6, ".trace") == 0) {
+      char *name = malloc(strlen(path) + length + 2);
+
+      sprintf(name, "%s/%s", path, entry->d_name);
+      *names = realloc(*names, (*count + 1) * sizeof(char *));
+      (*names)[(*count)++] = name;
+    }
+  }
+  closedir(dir);
+
+  qsort(*names + first, *count - first, sizeof(char *), compare_names);
+  return true;
+}
+
+#endif // PUPPET_TRACE_REPLAY_ONLY
+
+#endif // PUPPET_TRACE_H_
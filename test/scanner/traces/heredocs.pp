@@ -0,0 +1,37 @@
+$motd = @(MOTD)
+  Welcome to this server.
+  Unauthorized access is prohibited.
+  | MOTD
+
+$config = @("CONFIG"/L)
+    [main]
+    server = ${server}
+    port   = ${port}
+    user   = $user \
+    with a continued line
+    | CONFIG
+
+$script = @(END:bash/tn)
+  #!/bin/bash
+  echo "Starting\tservice"
+  exec /usr/sbin/daemon --config /etc/daemon.conf
+  |- END
+
+$json = @("JSON":json/$)
+  {
+    "name": "${name}",
+    "price": "\$${price}",
+    "tags": ${to_json($tags)}
+  }
+  | JSON
+
+notice(@(FIRST), @(SECOND))
+  first body
+  | FIRST
+  second body
+  | SECOND
+
+file { '/etc/motd':
+  ensure  => file,
+  content => $motd,
+}
@@ -0,0 +1,54 @@
+# A typical profile class
+class profile::webserver (
+  String $docroot = '/var/www/html',
+  Integer $port = 80,
+  Boolean $ssl = false,
+  Optional[String] $ssl_cert = undef,
+) {
+  $package = $facts['os']['family'] ? {
+    'RedHat' => 'httpd',
+    'Debian' => 'apache2',
+    default  => 'httpd',
+  }
+
+  $service_ensure = $ssl ? { true => 'running', default => 'stopped' }
+
+  package { $package:
+    ensure => installed,
+  }
+
+  file { [$docroot, "${docroot}/assets"]:
+    ensure  => directory,
+    owner   => 'www-data',
+    mode    => '0755',
+    require => Package[$package],
+  }
+
+  file { "${docroot}/index.html":
+    ensure  => file,
+    content => "<h1>${facts['networking']['fqdn']}</h1>\n",
+  }
+
+  if $ssl and $ssl_cert =~ /\.pem$/ {
+    notify { "Using certificate ${ssl_cert}": }
+  } elsif $port != 80 {
+    warning("Port ${port} is not the default")
+  }
+
+  case $facts['os']['name'] {
+    'Ubuntu', 'Debian': { include apt }
+    /^(RedHat|CentOS)$/: { include yum }
+    default: { fail("Unsupported OS ${facts['os']['name']}") }
+  }
+
+  service { $package:
+    ensure    => $service_ensure,
+    enable    => true,
+    subscribe => File["${docroot}/index.html"],
+  }
+
+  $users = ['alice', 'bob'].map |$name| { "${name}@example.com" }
+  $users.each |$index, $user| {
+    notice("User ${index}: ${user}")
+  }
+}
@@ -0,0 +1,18 @@
+# Quoted strings with escapes and interpolation
+$greeting = 'Hello, world'
+$quoted = 'It\'s a \\ backslash'
+$path = "/opt/${app}/releases/${version}"
+$message = "User $user logged in from ${facts['networking']['ip']}"
+$escaped = "Tab\tNewline\n Dollar \$HOME Quote \" Unicode é \u{1F600}"
+$nested = "Total: ${$count + 1} items in ${join($items, ', ')}"
+$empty = ''
+$blank = ""
+$unicode = "Grüße aus Köln – ${city}"
+
+notice("${greeting} from ${path}")
+notice('single quoted ${not} interpolated')
+
+$template = "server ${host}:${port} weight=${weight} max_fails=${max_fails}"
+$multiline = "first line
+second line with $var
+third line"
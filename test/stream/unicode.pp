@@ -0,0 +1,41 @@
+# Manifest with multi-byte UTF-8 characters: ä ö ü ß € ☃ 𝄞 😀
+#
+# puppet-stream parses it with windows of 1 to 7 bytes, so most of the
+# characters cross the end of a window.
+
+class greeting (
+  String $salutation = 'Grüß Gott',
+  String $currency   = "€ ${facts['os']['name']} ☃",
+) {
+  $emoji = '😀 and 𝄞'
+  $mixed = "ä${salutation}ö${currency}ü\n"
+
+  file { '/etc/motd':
+    ensure  => file,
+    content => @("MOTD"/L),
+      Willkommen, ${salutation}! ☃
+      Die Währung ist ${currency} und 😀 ist ein Emoji.
+      Noten: 𝄞 ♩ ♪ ♫ \
+      ohne Zeilenumbruch
+      | MOTD
+  }
+
+  notify { "Grüße ${emoji}": }
+
+  # Ein Kommentar über
+  # mehrere Zeilen: ¿¡ «» 中文
+
+  if $currency =~ /€|\$/ {
+    notify { 'Währung ist €': }
+  }
+
+  $hash = {
+    'schlüssel' => 'wert ✓',
+    'emoji'     => "😀${mixed}😀",
+  }
+
+  $text = @(END)
+    Zeile mit ü
+    Zeile mit 😀😀😀😀
+    END
+}
@@ -0,0 +1,387 @@
+/**************************************************************************
+ *
+ * Copyright (c) 2026 Stefan Möding
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **************************************************************************/
+
+/**
+ * Parallel syntax validator
+ *
+ * Usage: puppet-validate [-j threads] [path ...]
+ *
+ * Parses every manifest (*.pp) below the given paths (default: the current
+ * directory) and reports the syntax errors as JSON lines on stdout:
+ *
+ *   {"file": "manifests/init.pp", "line": 3, "column": 7,
+ *    "end_line": 3, "end_column": 9, "type": "ERROR", "message": "syntax error"}
+ *
+ * Lines and columns start at 1 and the columns count bytes. An ERROR node
+ * is reported once without the nodes inside it; a MISSING node has the
+ * missing token in the message. Directories starting with a dot are
+ * skipped. The files are sorted by path and the output follows this
+ * order, so it doesn't depend on the number of threads.
+ *
+ * The files are parsed on the given number of threads (default: the
+ * number of online processors) with one parser per thread. Every thread
+ * takes the next file from a shared index, starting with the largest
+ * files, so a large file at the end doesn't keep a single thread busy
+ * while the others are idle. The files are mapped into memory instead of
+ * being read.
+ *
+ * The exit status is 0 if all files are valid, 1 if a file has a syntax
+ * error and 2 if a file can't be read.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <tree_sitter/api.h>
+#include <tree_sitter/tree-sitter-puppet.h>
+
+
+typedef struct {
+  char     *path;
+  off_t    size;
+  char     *output;               // the JSON lines of the file
+  size_t   output_size;
+  unsigned errors;
+  bool     unreadable;
+} Manifest;
+
+typedef struct {
+  Manifest *contents;
+  size_t   size;
+  size_t   capacity;
+} Manifests;
+
+typedef struct {
+  Manifests   *manifests;
+  size_t      *order;             // the manifests sorted by size
+  atomic_size_t next;
+} Queue;
+
+
+static void manifests_add(Manifests *manifests, const char *path, off_t size) {
+  if (manifests->size == manifests->capacity) {
+    manifests->capacity = manifests->capacity ? manifests->capacity * 2 : 256;
+    manifests->contents = realloc(manifests->contents, manifests->capacity * sizeof(Manifest));
+  }
+  manifests->contents[manifests->size++] = (Manifest){ .path = strdup(path), .size = size };
+}
+
+/**
+ * Add the manifest at path or all manifests in the directory tree at path.
+ * Return false and print a message on stderr if path can't be read.
+ */
+
+static bool manifests_collect(Manifests *manifests, const char *path, bool explicit) {
+  struct stat st;
+
+  if (stat(path, &st) != 0) {
+    fprintf(stderr, "%s: no such file or directory\n", path);
+    return false;
+  }
+
+  if (S_ISREG(st.st_mode)) {
+    size_t length = strlen(path);
+
+    if (explicit || (length > 3 && strcmp(path + length - 3, ".pp") == 0)) {
+      manifests_add(manifests, path, st.st_size);
+    }
+    return true;
+  }
+  if (!S_ISDIR(st.st_mode)) return true;
+
+  // Don't follow symbolic links to directories, they may form a cycle
+  if (!explicit && lstat(path, &st) == 0 && S_ISLNK(st.st_mode)) return true;
+
+  DIR *dir = opendir(path);
+  bool ok = true;
+
+  if (!dir) {
+    fprintf(stderr, "%s: can't read directory\n", path);
+    return false;
+  }
+  for (struct dirent *entry; (entry = readdir(dir)) != NULL;) {
+    if (entry->d_name[0] == '.') continue;
+
+    size_t length = strlen(path);
+    char *name = malloc(length + strlen(entry->d_name) + 2);
+
+    sprintf(name, "%s%s%s", path, (length && path[length - 1] == '/') ? "" : "/", entry->d_name);
+    if (!manifests_collect(manifests, name, false)) ok = false;
+    free(name);
+  }
+  closedir(dir);
+  return ok;
+}
+
+static void json_string(FILE *file, const char *string) {
+  fputc('"', file);
+  for (const unsigned char *p = (const unsigned char *)string; *p; p++) {
+    if (*p == '"' || *p == '\\') {
+      fprintf(file, "\\%c", *p);
+    } else if (*p < 0x20) {
+      fprintf(file, "\\u%04x", *p);
+    } else {
+      fputc(*p, file);
+    }
+  }
+  fputc('"', file);
+}
+
+static void report_node(FILE *output, const Manifest *manifest, TSNode node, bool missing) {
+  TSPoint start = ts_node_start_point(node);
+  TSPoint end = ts_node_end_point(node);
+
+  fputs("{\"file\": ", output);
+  json_string(output, manifest->path);
+  fprintf(output, ", \"line\": %u, \"column\": %u, \"end_line\": %u, \"end_column\": %u",
+          start.row + 1, start.column + 1, end.row + 1, end.column + 1);
+  if (missing) {
+    fputs(", \"type\": \"MISSING\", \"message\": ", output);
+    char *message = malloc(strlen(ts_node_type(node)) + 9);
+    sprintf(message, "missing %s", ts_node_type(node));
+    json_string(output, message);
+    free(message);
+  } else {
+    fputs(", \"type\": \"ERROR\", \"message\": \"syntax error\"", output);
+  }
+  fputs("}\n", output);
+}
+
+/**
+ * Report the ERROR and MISSING nodes of the tree in document order. Only
+ * subtrees that contain an error are visited.
+ */
+
+static unsigned report_errors(FILE *output, const Manifest *manifest, TSTree *tree) {
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  unsigned errors = 0;
+
+  for (;;) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    bool descend = false;
+
+    if (ts_node_is_error(node)) {
+      report_node(output, manifest, node, false);
+      errors++;
+    } else if (ts_node_is_missing(node)) {
+      report_node(output, manifest, node, true);
+      errors++;
+    } else {
+      descend = ts_node_has_error(node);
+    }
+
+    if (descend && ts_tree_cursor_goto_first_child(&cursor)) continue;
+
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return errors;
+      }
+    }
+  }
+}
+
+static void validate(TSParser *parser, Manifest *manifest) {
+  int fd = open(manifest->path, O_RDONLY);
+  struct stat st;
+
+  if (fd < 0 || fstat(fd, &st) != 0 || st.st_size > (off_t)UINT32_MAX) {
+    if (fd >= 0) close(fd);
+    manifest->unreadable = true;
+    return;
+  }
+
+  // mmap doesn't map empty files
+  const char *source = "";
+
+  if (st.st_size > 0) {
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (map == MAP_FAILED) {
+      close(fd);
+      manifest->unreadable = true;
+      return;
+    }
+    source = map;
+  }
+  close(fd);
+
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)st.st_size);
+
+  if (ts_node_has_error(ts_tree_root_node(tree))) {
+    FILE *output = open_memstream(&manifest->output, &manifest->output_size);
+
+    manifest->errors = report_errors(output, manifest, tree);
+    fclose(output);
+  }
+
+  ts_tree_delete(tree);
+  if (st.st_size > 0) munmap((void *)source, (size_t)st.st_size);
+}
+
+static void *worker_run(void *payload) {
+  Queue *queue = payload;
+  TSParser *parser = ts_parser_new();
+
+  ts_parser_set_language(parser, tree_sitter_puppet());
+
+  for (;;) {
+    size_t next = atomic_fetch_add(&queue->next, 1);
+
+    if (next >= queue->manifests->size) break;
+    validate(parser, &queue->manifests->contents[queue->order[next]]);
+  }
+
+  ts_parser_delete(parser);
+  return NULL;
+}
+
+static const Manifests *sort_manifests;
+
+static int compare_paths(const void *a, const void *b) {
+  return strcmp(((const Manifest *)a)->path, ((const Manifest *)b)->path);
+}
+
+static int compare_sizes(const void *a, const void *b) {
+  off_t size_a = sort_manifests->contents[*(const size_t *)a].size;
+  off_t size_b = sort_manifests->contents[*(const size_t *)b].size;
+
+  if (size_a != size_b) return (size_a > size_b) ? -1 : 1;
+  return (*(const size_t *)a < *(const size_t *)b) ? -1 : 1;
+}
+
+static double now_seconds(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "Usage: %s [-j threads] [path ...]\n", program);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  Manifests manifests = {0};
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+  int threads = processors > 0 ? (int)processors : 1;
+  bool ok = true;
+  int option;
+
+  while ((option = getopt(argc, argv, "j:h")) != -1) {
+    switch (option) {
+    case 'j':
+      threads = atoi(optarg);
+      if (threads < 1) usage(argv[0]);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind == argc) {
+    ok = manifests_collect(&manifests, ".", false);
+  }
+  for (int i = optind; i < argc; i++) {
+    if (!manifests_collect(&manifests, argv[i], true)) ok = false;
+  }
+
+  double start = now_seconds();
+  uint64_t bytes = 0;
+
+  qsort(manifests.contents, manifests.size, sizeof(Manifest), compare_paths);
+
+  Queue queue = { .manifests = &manifests, .order = malloc((manifests.size + 1) * sizeof(size_t)) };
+
+  for (size_t i = 0; i < manifests.size; i++) {
+    queue.order[i] = i;
+    bytes += (uint64_t)manifests.contents[i].size;
+  }
+  sort_manifests = &manifests;
+  qsort(queue.order, manifests.size, sizeof(size_t), compare_sizes);
+  atomic_init(&queue.next, 0);
+
+  if ((size_t)threads > manifests.size) threads = manifests.size ? (int)manifests.size : 1;
+
+  pthread_t *ids = calloc((size_t)threads, sizeof(pthread_t));
+  int started = 0;
+
+  while (started < threads && pthread_create(&ids[started], NULL, worker_run, &queue) == 0) {
+    started++;
+  }
+  // Parse on the main thread if no thread could be started
+  if (started == 0) worker_run(&queue);
+  for (int i = 0; i < started; i++) {
+    pthread_join(ids[i], NULL);
+  }
+
+  size_t invalid = 0, unreadable = 0;
+  uint64_t errors = 0;
+
+  for (size_t i = 0; i < manifests.size; i++) {
+    Manifest *manifest = &manifests.contents[i];
+
+    if (manifest->unreadable) {
+      fprintf(stderr, "%s: can't read file\n", manifest->path);
+      unreadable++;
+    } else if (manifest->errors > 0) {
+      fwrite(manifest->output, 1, manifest->output_size, stdout);
+      errors += manifest->errors;
+      invalid++;
+    }
+    free(manifest->output);
+    free(manifest->path);
+  }
+
+  fprintf(stderr, "%zu files (%.1f MB), %llu errors in %zu files, %d threads, %.2f s\n",
+          manifests.size, (double)bytes / 1e6, (unsigned long long)errors, invalid,
+          started ? started : 1, now_seconds() - start);
+
+  free(ids);
+  free(queue.order);
+  free(manifests.contents);
+
+  if (!ok || unreadable > 0) return 2;
+  return invalid ? 1 : 0;
+}